@@ -0,0 +1,148 @@
+#pragma once
+// CPU topology lookup and thread pinning for the benchmarks. Only implemented
+// on Linux, where the topology comes from sysfs; elsewhere no placement is
+// available and the pinned benchmarks skip themselves.
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace bring_bench {
+
+// Where the consumer thread runs relative to the producer
+enum class Placement {
+  SameCore,    // both threads on one logical CPU, time-sliced
+  SmtSibling,  // two hyperthreads of one physical core, sharing L1/L2
+  CrossCore,   // two physical cores of one socket, sharing the LLC
+  CrossSocket, // two sockets, every handoff crosses the interconnect
+};
+
+inline const char *placement_name(Placement placement) {
+  switch (placement) {
+  case Placement::SameCore:
+    return "same_core";
+  case Placement::SmtSibling:
+    return "smt_sibling";
+  case Placement::CrossCore:
+    return "cross_core";
+  case Placement::CrossSocket:
+    return "cross_socket";
+  }
+  return "unknown";
+}
+
+struct CpuInfo {
+  int cpu;
+  int core;
+  int package;
+};
+
+namespace detail {
+
+inline int read_topology(int cpu, const char *file, int fallback) {
+  std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                   "/topology/" + file);
+  int value = fallback;
+  if (in >> value) {
+    return value;
+  }
+  return fallback;
+}
+
+} // namespace detail
+
+// CPUs this process may run on, with their core and socket ids
+inline std::vector<CpuInfo> allowed_cpus() {
+  std::vector<CpuInfo> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back({cpu, detail::read_topology(cpu, "core_id", cpu),
+                      detail::read_topology(cpu, "physical_package_id", 0)});
+    }
+  }
+#endif
+  return cpus;
+}
+
+// Producer and consumer CPUs for a placement, or nullopt if this machine
+// (or the affinity mask the process was started with) has no such pair
+inline std::optional<std::pair<int, int>> pick_cpus(Placement placement) {
+  const std::vector<CpuInfo> cpus = allowed_cpus();
+  if (cpus.empty()) {
+    return std::nullopt;
+  }
+  if (placement == Placement::SameCore) {
+    return std::pair{cpus[0].cpu, cpus[0].cpu};
+  }
+
+  for (const CpuInfo &first : cpus) {
+    for (const CpuInfo &second : cpus) {
+      if (first.cpu == second.cpu) {
+        continue;
+      }
+      const bool same_package = first.package == second.package;
+      const bool same_core = same_package && first.core == second.core;
+      const bool match =
+          (placement == Placement::SmtSibling && same_core) ||
+          (placement == Placement::CrossCore && same_package && !same_core) ||
+          (placement == Placement::CrossSocket && !same_package);
+      if (match) {
+        return std::pair{first.cpu, second.cpu};
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+inline bool pin_current_thread(int cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  static_cast<void>(cpu);
+  return false;
+#endif
+}
+
+// Restores the calling thread's original affinity when it goes out of scope,
+// so a pinned benchmark does not leak its pinning into the next one
+class AffinityGuard {
+#if defined(__linux__)
+  cpu_set_t _saved{};
+  bool _valid;
+
+public:
+  AffinityGuard()
+      : _valid(pthread_getaffinity_np(pthread_self(), sizeof(_saved),
+                                      &_saved) == 0) {}
+  ~AffinityGuard() {
+    if (_valid) {
+      pthread_setaffinity_np(pthread_self(), sizeof(_saved), &_saved);
+    }
+  }
+#else
+public:
+  AffinityGuard() = default;
+  ~AffinityGuard() = default;
+#endif
+  AffinityGuard(const AffinityGuard &) = delete;
+  AffinityGuard &operator=(const AffinityGuard &) = delete;
+  AffinityGuard(AffinityGuard &&) = delete;
+  AffinityGuard &operator=(AffinityGuard &&) = delete;
+};
+
+} // namespace bring_bench
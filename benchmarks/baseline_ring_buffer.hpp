@@ -0,0 +1,70 @@
+#pragma once
+// Reference copy of the original RingBuffer hot path, kept only so the
+// benchmarks can compare new variants against it. Every operation loads the
+// other side's index from the shared atomic.
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace bring_bench {
+
+template <typename T, size_t Capacity> class BaselineRingBuffer {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be power of two");
+
+private:
+  struct Slot {
+    alignas(T) std::array<std::byte, sizeof(T)> _data;
+  };
+
+  static constexpr size_t align_size{64};
+  alignas(align_size) std::atomic<size_t> _head{0};
+  alignas(align_size) std::atomic<size_t> _tail{0};
+
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  std::unique_ptr<Slot[]> _storage;
+
+  T *get_ptr(size_t idx) noexcept {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<T *>(&_storage[idx]._data);
+  }
+
+public:
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  BaselineRingBuffer() : _storage(std::make_unique<Slot[]>(Capacity)) {}
+  ~BaselineRingBuffer() {
+    while (try_pop()) {
+    }
+  }
+  BaselineRingBuffer(const BaselineRingBuffer &) = delete;
+  BaselineRingBuffer &operator=(const BaselineRingBuffer &) = delete;
+  BaselineRingBuffer(BaselineRingBuffer &&) = delete;
+  BaselineRingBuffer &operator=(BaselineRingBuffer &&) = delete;
+
+  template <typename U> bool try_push(U &&item) {
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    const size_t next_head = (current_head + 1) & (Capacity - 1);
+    if (next_head == _tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    new (get_ptr(current_head)) T(std::forward<U>(item));
+    _head.store(next_head, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] std::optional<T> try_pop() {
+    const size_t current_tail = _tail.load(std::memory_order_relaxed);
+    if (current_tail == _head.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    T *element_ptr = get_ptr(current_tail);
+    std::optional<T> result(std::move(*element_ptr));
+    element_ptr->~T();
+    _tail.store((current_tail + 1) & (Capacity - 1), std::memory_order_release);
+    return result;
+  }
+};
+
+} // namespace bring_bench
@@ -0,0 +1,786 @@
+#include "affinity.hpp"
+#include "baseline_ring_buffer.hpp"
+#include "mutex_queue.hpp"
+#include "perf_counters.hpp"
+#include <benchmark/benchmark.h>
+#include <bring/byte_ring_buffer.hpp>
+#include <bring/memory_resource.hpp>
+#include <bring/mpmc_ring_buffer.hpp>
+#include <bring/overwrite_ring_buffer.hpp>
+#include <bring/pipeline.hpp>
+#include <bring/pool_channel.hpp>
+#include <bring/priority_ring_buffer.hpp>
+#include <bring/ring_buffer.hpp>
+#include <bring/ring_set.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <bring/eventfd_wait.hpp>
+#endif
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-identifier-length,cppcoreguidelines-owning-memory)
+
+namespace {
+
+constexpr size_t CAPACITY = 1024;
+
+using Baseline = bring_bench::BaselineRingBuffer<uint64_t, CAPACITY>;
+using Cached = bring::RingBuffer<uint64_t, CAPACITY>;
+using Dynamic = bring::DynamicRingBuffer<uint64_t>;
+// Slots embedded in the ring object, no pointer load per access
+using Inline = bring::RingBuffer<uint64_t, CAPACITY, bring::InlineStorage>;
+// Pays a fence and a parked-flag check on every publish
+using Parking = bring::RingBuffer<uint64_t, CAPACITY, bring::AtomicWait<>>;
+#if defined(__linux__)
+// Fence and sleeping-flag check per publish, eventfd write only for a sleeper
+using Notified = bring::RingBuffer<uint64_t, CAPACITY, bring::EventFdWait<>>;
+#endif
+// Index stores coalesced on both sides, every Interval elements
+template <size_t Interval>
+using Deferred =
+    bring::RingBuffer<uint64_t, CAPACITY, bring::DeferredPublish<Interval>>;
+// Counts every push and pop on each side's own cache line
+using Counted = bring::RingBuffer<uint64_t, CAPACITY, bring::RingStats>;
+// Stamps one push in 1024 and records its dwell time when it is popped
+using Sampled =
+    bring::RingBuffer<uint64_t, CAPACITY, bring::LatencySampling<1024>>;
+
+using Locked = bring_bench::MutexQueue<uint64_t, CAPACITY>;
+using Mpmc = bring::MpmcRingBuffer<uint64_t, CAPACITY>;
+
+template <typename Ring> std::unique_ptr<Ring> make_ring() {
+  if constexpr (std::is_constructible_v<Ring, size_t>) {
+    return std::make_unique<Ring>(CAPACITY);
+  } else {
+    return std::make_unique<Ring>();
+  }
+}
+
+// Single thread: fill and drain a ring repeatedly. Measures the raw cost of
+// the push/pop path when nothing is contended.
+template <typename Ring> void BM_SPSC_FillDrain(benchmark::State &state) {
+  auto ring = make_ring<Ring>();
+  const auto batch = static_cast<uint64_t>(state.range(0));
+  bring_bench::PerfCounters perf;
+  perf.start();
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < batch; ++i) {
+      benchmark::DoNotOptimize(ring->try_push(i));
+    }
+    for (uint64_t i = 0; i < batch; ++i) {
+      auto value = ring->try_pop();
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  perf.stop();
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch) * 2);
+  bring_bench::report_perf(
+      state, perf.read(), "op",
+      static_cast<double>(state.iterations() * batch * 2));
+}
+
+// Two threads: the benchmark thread pushes one item per iteration while a
+// dedicated consumer thread drains. Measures the cross-core handoff cost.
+template <typename Ring> void BM_SPSC_Throughput(benchmark::State &state) {
+  auto ring = make_ring<Ring>();
+  std::atomic<bool> done{false};
+  std::vector<bring_bench::PerfReading> consumer_perf;
+
+  std::thread consumer([&]() {
+    bring_bench::PerfCounters perf;
+    perf.start();
+    while (true) {
+      auto value = ring->try_pop();
+      if (value.has_value()) {
+        benchmark::DoNotOptimize(value);
+      } else if (done.load(std::memory_order_acquire)) {
+        // Producer finished, drain anything left before exiting
+        while (ring->try_pop()) {
+        }
+        break;
+      }
+    }
+    perf.stop();
+    consumer_perf = perf.read();
+  });
+
+  bring_bench::PerfCounters perf;
+  perf.start();
+  uint64_t i = 0;
+  for (auto _ : state) {
+    while (!ring->try_push(i)) {
+    }
+    ++i;
+  }
+  if constexpr (requires { ring->publish(); }) {
+    ring->publish();
+  }
+  perf.stop();
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  state.SetItemsProcessed(state.iterations());
+  // Every pushed element is popped, so both sides divide by the same count
+  const auto elements = static_cast<double>(state.iterations());
+  bring_bench::report_perf(state, perf.read(), "push", elements);
+  bring_bench::report_perf(state, consumer_perf, "pop", elements);
+}
+
+// BM_SPSC_Throughput with a third thread polling get_state() as fast as it
+// can, like a monitoring exporter. The gap to the unobserved run is what the
+// observer's loads of head and tail cost the data path
+void BM_SPSC_Observed(benchmark::State &state) {
+  auto ring = make_ring<Cached>();
+  std::atomic<bool> done{false};
+
+  std::thread observer([&]() {
+    size_t samples = 0;
+    while (!done.load(std::memory_order_acquire)) {
+      benchmark::DoNotOptimize(ring->get_state());
+      ++samples;
+    }
+    benchmark::DoNotOptimize(samples);
+  });
+  std::thread consumer([&]() {
+    while (true) {
+      auto value = ring->try_pop();
+      if (value.has_value()) {
+        benchmark::DoNotOptimize(value);
+      } else if (done.load(std::memory_order_acquire)) {
+        while (ring->try_pop()) {
+        }
+        return;
+      }
+    }
+  });
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    while (!ring->try_push(i)) {
+    }
+    ++i;
+  }
+  done.store(true, std::memory_order_release);
+  consumer.join();
+  observer.join();
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Single thread: same fill/drain pattern in batches of state.range(0) using
+// the bulk API, one index publication per batch instead of per element
+void BM_SPSC_BulkFillDrain(benchmark::State &state) {
+  auto ring = std::make_unique<Cached>();
+  const auto batch = static_cast<size_t>(state.range(0));
+  std::vector<uint64_t> in(batch, 1);
+  std::vector<uint64_t> out(batch);
+  const size_t rounds = CAPACITY / batch;
+  bring_bench::PerfCounters perf;
+  perf.start();
+  for (auto _ : state) {
+    for (size_t r = 0; r < rounds; ++r) {
+      benchmark::DoNotOptimize(
+          ring->try_push_n(std::span<const uint64_t>(in)));
+    }
+    for (size_t r = 0; r < rounds; ++r) {
+      benchmark::DoNotOptimize(ring->try_pop_n(std::span<uint64_t>(out)));
+    }
+  }
+  perf.stop();
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(rounds * batch) * 2);
+  bring_bench::report_perf(
+      state, perf.read(), "op",
+      static_cast<double>(state.iterations() * rounds * batch * 2));
+}
+
+// Two threads with bulk transfers on both sides
+void BM_SPSC_BulkThroughput(benchmark::State &state) {
+  auto ring = std::make_unique<Cached>();
+  const auto batch = static_cast<size_t>(state.range(0));
+  std::atomic<bool> done{false};
+  std::vector<bring_bench::PerfReading> consumer_perf;
+
+  std::thread consumer([&]() {
+    bring_bench::PerfCounters perf;
+    perf.start();
+    std::vector<uint64_t> out(batch);
+    while (true) {
+      const size_t popped = ring->try_pop_n(std::span<uint64_t>(out));
+      benchmark::DoNotOptimize(out.data());
+      if (popped == 0 && done.load(std::memory_order_acquire) &&
+          ring->is_empty()) {
+        break;
+      }
+    }
+    perf.stop();
+    consumer_perf = perf.read();
+  });
+
+  bring_bench::PerfCounters perf;
+  perf.start();
+  std::vector<uint64_t> in(batch, 1);
+  for (auto _ : state) {
+    size_t sent = 0;
+    while (sent < batch) {
+      sent += ring->try_push_n(
+          std::span<const uint64_t>(in.data() + sent, batch - sent));
+    }
+  }
+  perf.stop();
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+  const auto elements = static_cast<double>(state.iterations() * batch);
+  bring_bench::report_perf(state, perf.read(), "push", elements);
+  bring_bench::report_perf(state, consumer_perf, "pop", elements);
+}
+
+// N threads share one queue; every iteration pushes one item and pops one.
+// Each thread has at most one item outstanding, so the queue never fills and
+// a pop only fails while another thread's push is still being published
+template <typename Queue> void BM_MPMC_Scaling(benchmark::State &state) {
+  static std::unique_ptr<Queue> queue;
+  if (state.thread_index() == 0) {
+    queue = std::make_unique<Queue>();
+  }
+  // The benchmark library starts timing only after every thread got here
+  for (auto _ : state) {
+    while (!queue->try_push(uint64_t{1})) {
+    }
+    auto value = queue->try_pop();
+    while (!value) {
+      value = queue->try_pop();
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Fixed-size message for the transfer matrix. Bytes is the element size the
+// ring actually copies per push and pop
+template <size_t Bytes> struct Payload {
+  std::array<std::byte, Bytes> bytes{};
+};
+
+// Single thread: bulk fill/drain of trivially copyable 32-byte payloads, the
+// case the memcpy segment path is for. Batches of state.range(0) elements
+void BM_SPSC_BulkPayload(benchmark::State &state) {
+  using Message = Payload<32>;
+  auto ring = std::make_unique<bring::RingBuffer<Message, CAPACITY>>();
+  const auto batch = static_cast<size_t>(state.range(0));
+  std::vector<Message> in(batch);
+  std::vector<Message> out(batch);
+  const size_t rounds = CAPACITY / batch;
+  bring_bench::PerfCounters perf;
+  perf.start();
+  for (auto _ : state) {
+    for (size_t r = 0; r < rounds; ++r) {
+      benchmark::DoNotOptimize(ring->try_push_n(std::span<const Message>(in)));
+    }
+    for (size_t r = 0; r < rounds; ++r) {
+      benchmark::DoNotOptimize(ring->try_pop_n(std::span<Message>(out)));
+    }
+    benchmark::ClobberMemory();
+  }
+  perf.stop();
+  bring_bench::report_perf(
+      state, perf.read(), "op",
+      static_cast<double>(state.iterations() * rounds * batch * 2));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(rounds * batch) * 2);
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(rounds * batch * 32) * 2);
+}
+
+// Single thread: fill a ring of 256-byte messages, then drain it in one
+// burst. PrefetchDistance 0 with PublishEvery 1 is the element-at-a-time
+// try_consume() loop; the others use consume_all() with prefetching and
+// one tail store per PublishEvery elements (0: per burst)
+template <size_t PrefetchDistance, size_t PublishEvery>
+void BM_SPSC_BurstConsume(benchmark::State &state) {
+  using Message = Payload<256>;
+  auto ring = std::make_unique<bring::RingBuffer<Message, CAPACITY>>();
+  const Message message{};
+  uint64_t checksum = 0;
+  // Touches each of the message's four cache lines
+  const auto process = [&](Message &&value) {
+    for (size_t offset = 0; offset < value.bytes.size(); offset += 64) {
+      checksum += std::to_integer<uint64_t>(value.bytes.at(offset));
+    }
+  };
+  for (auto _ : state) {
+    while (ring->try_push(message)) {
+    }
+    if constexpr (PrefetchDistance == 0 && PublishEvery == 1) {
+      while (ring->try_consume(process)) {
+      }
+    } else {
+      ring->template consume_all<PrefetchDistance, PublishEvery>(process);
+    }
+    benchmark::DoNotOptimize(checksum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(CAPACITY));
+}
+
+// Single thread: four laps of 32-byte telemetry samples into a ring nobody
+// drains until the end, then one drain of what survived. The overwriting
+// ring pushes unconditionally; the emulation pops the oldest entry from the
+// producer side whenever a RingBuffer is full
+void BM_Overwrite_Push(benchmark::State &state) {
+  using Message = Payload<32>;
+  auto ring = std::make_unique<bring::OverwriteRingBuffer<Message, CAPACITY>>();
+  const Message message{};
+  for (auto _ : state) {
+    for (size_t i = 0; i < 4 * CAPACITY; ++i) {
+      ring->push(message);
+    }
+    benchmark::DoNotOptimize(ring->consume_n(CAPACITY, [](const Message &m) {
+      benchmark::DoNotOptimize(&m);
+    }));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(4 * CAPACITY));
+}
+
+void BM_Overwrite_EmulatedPush(benchmark::State &state) {
+  using Message = Payload<32>;
+  auto ring = std::make_unique<bring::RingBuffer<Message, CAPACITY>>();
+  const Message message{};
+  for (auto _ : state) {
+    for (size_t i = 0; i < 4 * CAPACITY; ++i) {
+      if (!ring->try_push(message)) {
+        benchmark::DoNotOptimize(ring->try_pop());
+        benchmark::DoNotOptimize(ring->try_push(message));
+      }
+    }
+    benchmark::DoNotOptimize(ring->consume_n(CAPACITY, [](Message &&m) {
+      benchmark::DoNotOptimize(&m);
+    }));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(4 * CAPACITY));
+}
+
+// One try_push for a single element, so the comparison with a batch of one
+// is not skewed by try_push_n's setup
+template <typename Ring>
+void push_batch(Ring &ring, const std::vector<uint64_t> &batch) {
+  if (batch.size() == 1) {
+    benchmark::DoNotOptimize(ring.try_push(batch.front()));
+  } else {
+    benchmark::DoNotOptimize(ring.try_push_n(batch));
+  }
+}
+
+// Single thread: 64 rings of which state.range(0) get state.range(1)
+// elements per pass, pushed as one batch. The set scans its ready mask; the
+// manual loop checks every ring. Both rings and mask stay in this core's
+// cache, so this measures instructions, not the cache misses an idle ring
+// costs when its producer runs on another core. Each RingSet publish pays a
+// fence, so larger batches show how far batching amortizes it
+void BM_RingSet_Poll(benchmark::State &state) {
+  auto set = std::make_unique<bring::RingSet<uint64_t, 64, 64>>();
+  const auto active = static_cast<size_t>(state.range(0));
+  const std::vector<uint64_t> batch(static_cast<size_t>(state.range(1)), 1);
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < active; ++i) {
+      push_batch(set->ring(i * (64 / active)), batch);
+    }
+    set->poll([&](size_t /*ring*/, uint64_t &&value) { sum += value; });
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(active * batch.size()));
+}
+
+void BM_ManualPoll(benchmark::State &state) {
+  auto rings = std::make_unique<std::array<bring::RingBuffer<uint64_t, 64>, 64>>();
+  const auto active = static_cast<size_t>(state.range(0));
+  const std::vector<uint64_t> batch(static_cast<size_t>(state.range(1)), 1);
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < active; ++i) {
+      push_batch((*rings)[i * (64 / active)], batch);
+    }
+    for (auto &ring : *rings) {
+      if (!ring.is_empty()) {
+        ring.consume_n(64, [&](uint64_t &&value) { sum += value; });
+      }
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(active * batch.size()));
+}
+
+// Three cheap stages, state.range(0) elements per run: either each on its
+// own thread with a ring hop in between, or the middle stage fused onto the
+// first stage's thread. Includes thread start and shutdown
+template <bool Fuse> void BM_Pipeline(benchmark::State &state) {
+  const auto count = static_cast<uint64_t>(state.range(0));
+  const auto scale = [](uint64_t &&v) { return v * 3; };
+  const auto offset = [](uint64_t &&v) { return v + 1; };
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    const auto sink = [&sum](uint64_t &&v) { sum += v; };
+    const auto run = [&](auto pipeline_stage) {
+      auto pipeline = bring::make_pipeline<uint64_t, CAPACITY>(
+          bring::stage(scale).template wait<bring::SpinYieldWait<>>(),
+          std::move(pipeline_stage),
+          bring::stage(sink).template wait<bring::SpinYieldWait<>>());
+      pipeline.start();
+      for (uint64_t i = 0; i < count; ++i) {
+        pipeline.push(i);
+      }
+      pipeline.close();
+    };
+    if constexpr (Fuse) {
+      run(bring::fused(offset));
+    } else {
+      run(bring::stage(offset).template wait<bring::SpinYieldWait<>>());
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Two threads passing messages that own state.range(0)-byte heap payloads:
+// a plain ring of std::vector, which allocates on the producer and frees on
+// the consumer for every message, against a PoolChannel that recycles a
+// fixed set of buffers
+template <bool Pooled> void BM_HeapPayloads(benchmark::State &state) {
+  using Buffer = std::vector<std::byte>;
+  using Channel = bring::PoolChannel<Buffer, 256>;
+  using Ring = bring::RingBuffer<Buffer, 256>;
+  const auto bytes = static_cast<size_t>(state.range(0));
+  std::conditional_t<Pooled, Channel, Ring> queue = [&]() {
+    if constexpr (Pooled) {
+      return Channel([bytes](Buffer &buffer) { buffer.reserve(bytes); });
+    } else {
+      return Ring{};
+    }
+  }();
+  std::atomic<bool> done{false};
+
+  std::thread consumer([&]() {
+    uint64_t sum = 0;
+    const auto drain = [&]() {
+      if constexpr (Pooled) {
+        auto message = queue.try_receive();
+        if (message.has_value()) {
+          sum += std::to_integer<uint64_t>((*message)->back());
+        }
+        return message.has_value();
+      } else {
+        auto message = queue.try_pop();
+        if (message.has_value()) {
+          sum += std::to_integer<uint64_t>(message->back());
+        }
+        return message.has_value();
+      }
+    };
+    while (drain() || !done.load(std::memory_order_acquire)) {
+    }
+    while (drain()) {
+    }
+    benchmark::DoNotOptimize(sum);
+  });
+
+  for (auto _ : state) {
+    if constexpr (Pooled) {
+      std::optional<Channel::Lease> lease;
+      while (!(lease = queue.try_acquire())) {
+      }
+      (*lease)->resize(bytes);
+      std::memset((*lease)->data(), 1, bytes);
+      queue.send(std::move(*lease));
+    } else {
+      Buffer buffer(bytes);
+      std::memset(buffer.data(), 1, bytes);
+      while (!queue.try_push(std::move(buffer))) {
+      }
+    }
+  }
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Single thread: BM_SPSC_FillDrain over two lanes of CAPACITY / 2, half
+// the elements in each, popped one at a time. The gap to
+// BM_SPSC_FillDrain<Cached> is what choosing a lane costs per pop
+template <typename Priority>
+void BM_Priority_FillDrain(benchmark::State &state) {
+  using Lanes = bring::Lanes<CAPACITY / 2, CAPACITY / 2>;
+  auto ring =
+      std::make_unique<bring::PriorityRingBuffer<uint64_t, Lanes, Priority>>();
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < CAPACITY; ++i) {
+      benchmark::DoNotOptimize(ring->try_push(i & 1, i));
+    }
+    for (uint64_t i = 0; i < CAPACITY; ++i) {
+      auto value = ring->try_pop();
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(CAPACITY) * 2);
+}
+
+// Single thread: records of 24 B to 4 KiB through a byte ring, each written
+// in place with reserve()/commit() and read with peek()/release(). Measures
+// per-record overhead including the padding written at the wrap point
+void BM_ByteRing_Records(benchmark::State &state) {
+  auto ring = std::make_unique<bring::ByteRingBuffer<size_t{1} << 16>>();
+  constexpr std::array<size_t, 8> sizes{24, 64, 24, 200, 24, 1024, 48, 4096};
+  size_t next = 0;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < 16; ++i) {
+      const size_t size = sizes[next++ % sizes.size()];
+      const std::span<std::byte> space = ring->reserve(size);
+      if (space.empty()) {
+        break;
+      }
+      std::memset(space.data(), 1, size);
+      ring->commit();
+      bytes += static_cast<int64_t>(size);
+    }
+    while (ring->try_consume([](std::span<const std::byte> record) {
+      benchmark::DoNotOptimize(record.data());
+    })) {
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 16);
+  state.SetBytesProcessed(bytes);
+}
+
+// Two threads pinned according to `placement`: the benchmark thread pushes
+// one Payload<Bytes> per iteration while a consumer thread drains. Reports
+// items/s (ops/sec) and bytes/s of payload moved
+template <typename Queue, size_t Bytes>
+void BM_PinnedTransfer(benchmark::State &state,
+                       bring_bench::Placement placement) {
+  const auto cpus = bring_bench::pick_cpus(placement);
+  if (!cpus) {
+    state.SkipWithError("placement not available on this machine");
+    return;
+  }
+  const bring_bench::AffinityGuard restore_affinity;
+  if (!bring_bench::pin_current_thread(cpus->first)) {
+    state.SkipWithError("could not pin the producer thread");
+    return;
+  }
+
+  auto queue = std::make_unique<Queue>();
+  std::atomic<bool> done{false};
+  std::thread consumer([&]() {
+    bring_bench::pin_current_thread(cpus->second);
+    unsigned attempt = 0;
+    while (true) {
+      auto value = queue->try_pop();
+      if (value.has_value()) {
+        benchmark::DoNotOptimize(value);
+        attempt = 0;
+      } else if (done.load(std::memory_order_acquire)) {
+        while (queue->try_pop()) {
+        }
+        return;
+      } else {
+        // Spin briefly, then yield so a same-core producer gets to run
+        bring::SpinYieldWait<>::pause(attempt);
+      }
+    }
+  });
+
+  const Payload<Bytes> message{};
+  for (auto _ : state) {
+    unsigned attempt = 0;
+    while (!queue->try_push(message)) {
+      bring::SpinYieldWait<>::pause(attempt);
+    }
+  }
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(Bytes));
+}
+
+// Single thread: stream 2^20 128-byte messages through one lap of a large ring
+// whose slots come from `options`. Exposes TLB and page-fault costs of the
+// storage: regular heap pages take faults on the first lap and a TLB miss on
+// most 4 KiB boundaries; prefaulted huge pages should take neither
+void BM_LargeRing_Storage(benchmark::State &state,
+                          std::optional<bring::MappedMemoryOptions> options) {
+  constexpr size_t large_capacity = size_t{1} << 20;
+  using Message = Payload<128>;
+  using Ring =
+      bring::RingBuffer<Message, large_capacity, bring::ResourceStorage>;
+
+  std::optional<bring::MappedMemoryResource> mapped;
+  if (options) {
+    mapped.emplace(*options);
+  }
+  std::pmr::memory_resource *resource =
+      mapped ? &*mapped : std::pmr::new_delete_resource();
+  std::unique_ptr<Ring> ring;
+  try {
+    ring = std::make_unique<Ring>(resource);
+  } catch (const std::exception &) {
+    state.SkipWithError("storage not available on this machine");
+    return;
+  }
+
+  const Message message{};
+  for (auto _ : state) {
+    for (size_t i = 0; i < large_capacity; ++i) {
+      benchmark::DoNotOptimize(ring->try_push(message));
+    }
+    ring->consume_n(large_capacity, [](Message &&value) {
+      benchmark::DoNotOptimize(value);
+    });
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(large_capacity));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(large_capacity * 128));
+}
+
+bring::MappedMemoryOptions mapped_options(bring::PageSize pages) {
+  bring::MappedMemoryOptions options;
+  options.pages = pages;
+  options.prefault = true;
+  return options;
+}
+
+template <typename Queue, size_t Bytes>
+void register_transfer(const std::string &queue_name, size_t capacity) {
+  for (const auto placement :
+       {bring_bench::Placement::SameCore, bring_bench::Placement::SmtSibling,
+        bring_bench::Placement::CrossCore,
+        bring_bench::Placement::CrossSocket}) {
+    const std::string name = "BM_PinnedTransfer/" + queue_name +
+                             "/cap:" + std::to_string(capacity) +
+                             "/bytes:" + std::to_string(Bytes) + "/" +
+                             bring_bench::placement_name(placement);
+    benchmark::RegisterBenchmark(name.c_str(),
+                                 BM_PinnedTransfer<Queue, Bytes>, placement)
+        ->UseRealTime();
+  }
+}
+
+template <size_t Capacity, size_t... Sizes> void register_transfers() {
+  (register_transfer<bring::RingBuffer<Payload<Sizes>, Capacity>, Sizes>(
+       "RingBuffer", Capacity),
+   ...);
+  (register_transfer<bring_bench::MutexQueue<Payload<Sizes>, Capacity>,
+                     Sizes>("MutexQueue", Capacity),
+   ...);
+}
+
+} // namespace
+
+// The baseline can only hold CAPACITY - 1 elements, so compare at that fill
+BENCHMARK(BM_SPSC_FillDrain<Baseline>)->Arg(CAPACITY - 1);
+BENCHMARK(BM_SPSC_FillDrain<Cached>)->Arg(CAPACITY - 1)->Arg(CAPACITY);
+BENCHMARK(BM_SPSC_FillDrain<Dynamic>)->Arg(CAPACITY - 1)->Arg(CAPACITY);
+BENCHMARK(BM_SPSC_FillDrain<Inline>)->Arg(CAPACITY - 1)->Arg(CAPACITY);
+BENCHMARK(BM_SPSC_FillDrain<Parking>)->Arg(CAPACITY);
+#if defined(__linux__)
+BENCHMARK(BM_SPSC_FillDrain<Notified>)->Arg(CAPACITY);
+#endif
+BENCHMARK(BM_SPSC_FillDrain<Counted>)->Arg(CAPACITY);
+BENCHMARK(BM_SPSC_FillDrain<Sampled>)->Arg(CAPACITY);
+BENCHMARK(BM_SPSC_Throughput<Baseline>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Cached>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Dynamic>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Inline>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Parking>)->UseRealTime();
+#if defined(__linux__)
+BENCHMARK(BM_SPSC_Throughput<Notified>)->UseRealTime();
+#endif
+BENCHMARK(BM_SPSC_Throughput<Counted>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Sampled>)->UseRealTime();
+BENCHMARK(BM_SPSC_Observed)->UseRealTime();
+BENCHMARK(BM_SPSC_FillDrain<Deferred<16>>)->Arg(CAPACITY);
+BENCHMARK(BM_SPSC_Throughput<Deferred<1>>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Deferred<4>>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Deferred<16>>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Deferred<64>>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<Deferred<256>>)->UseRealTime();
+BENCHMARK(BM_SPSC_BulkFillDrain)->RangeMultiplier(4)->Range(16, 256);
+BENCHMARK(BM_SPSC_BulkPayload)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_SPSC_BurstConsume<0, 1>);
+BENCHMARK(BM_SPSC_BurstConsume<0, 0>);
+BENCHMARK(BM_SPSC_BurstConsume<4, 0>);
+BENCHMARK(BM_SPSC_BurstConsume<8, 0>);
+BENCHMARK(BM_SPSC_BurstConsume<8, 64>);
+BENCHMARK(BM_ByteRing_Records);
+BENCHMARK(BM_Overwrite_Push);
+BENCHMARK(BM_Overwrite_EmulatedPush);
+BENCHMARK(BM_RingSet_Poll)->ArgsProduct({{1, 8, 64}, {1, 16}});
+BENCHMARK(BM_ManualPoll)->ArgsProduct({{1, 8, 64}, {1, 16}});
+BENCHMARK(BM_Pipeline<false>)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(BM_Pipeline<true>)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(BM_Priority_FillDrain<bring::StrictPriority>);
+BENCHMARK(BM_Priority_FillDrain<bring::WeightedPriority<4, 1>>);
+BENCHMARK(BM_HeapPayloads<false>)->Arg(256)->Arg(4096)->UseRealTime();
+BENCHMARK(BM_HeapPayloads<true>)->Arg(256)->Arg(4096)->UseRealTime();
+BENCHMARK(BM_SPSC_BulkThroughput)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_LargeRing_Storage, heap, std::nullopt);
+BENCHMARK_CAPTURE(BM_LargeRing_Storage, mapped_prefault,
+                  mapped_options(bring::PageSize::Default));
+BENCHMARK_CAPTURE(BM_LargeRing_Storage, transparent_huge_prefault,
+                  mapped_options(bring::PageSize::Transparent));
+BENCHMARK_CAPTURE(BM_LargeRing_Storage, huge_2m_prefault,
+                  mapped_options(bring::PageSize::Huge2M));
+BENCHMARK(BM_MPMC_Scaling<Locked>)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_MPMC_Scaling<Mpmc>)->ThreadRange(1, 16)->UseRealTime();
+
+// The pinned transfer matrix is registered at runtime so its names can carry
+// the queue, capacity, element size and placement
+int main(int argc, char **argv) {
+  bring_bench::parse_perf_flag(argc, argv);
+  register_transfers<64, 4, 16, 64, 256>();
+  register_transfers<1024, 4, 16, 64, 256>();
+  register_transfers<65536, 4, 16, 64, 256>();
+  // Same transfer with 64- and 128-byte field padding, to check on each
+  // machine whether adjacent-line prefetching makes 64 bytes too little
+  register_transfer<bring::RingBuffer<Payload<16>, 1024,
+                                      bring::CacheLinePadding<64>>,
+                    16>("RingBuffer_pad64", 1024);
+  register_transfer<bring::RingBuffer<Payload<16>, 1024, bring::Padding128>,
+                    16>("RingBuffer_pad128", 1024);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-identifier-length,cppcoreguidelines-owning-memory)
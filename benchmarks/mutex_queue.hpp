@@ -0,0 +1,37 @@
+#pragma once
+// std::mutex + std::deque queue with the ring API, used as the baseline the
+// lock-free multi-threaded rings are measured against.
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace bring_bench {
+
+template <typename T, size_t Capacity> class MutexQueue {
+  mutable std::mutex _mutex;
+  std::deque<T> _items;
+
+public:
+  template <typename U> bool try_push(U &&item) {
+    const std::scoped_lock lock(_mutex);
+    if (_items.size() == Capacity) {
+      return false;
+    }
+    _items.push_back(std::forward<U>(item));
+    return true;
+  }
+
+  std::optional<T> try_pop() {
+    const std::scoped_lock lock(_mutex);
+    if (_items.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> result(std::move(_items.front()));
+    _items.pop_front();
+    return result;
+  }
+};
+
+} // namespace bring_bench
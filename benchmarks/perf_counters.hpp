@@ -0,0 +1,206 @@
+#pragma once
+// Hardware performance counters for the benchmarks, read with Linux's
+// perf_event_open. Each thread that wants counts opens its own group, since
+// a group only counts the thread that opened it; the two-thread benchmarks
+// report the producer's counts per push and the consumer's per pop.
+//
+// Counting is off unless the benchmark binary is started with
+// --perf_counters. It needs perf_event_paranoid <= 2 (user-space counts of
+// the own process) and a PMU the kernel exposes, which many VMs do not;
+// events the kernel refuses are left out, and a benchmark reports nothing
+// when none could be opened. Elsewhere than Linux the group is always empty.
+//
+// Generic events cover instructions, branch misses and L1D/LLC read misses.
+// There is no generic event for loads that hit a line modified in another
+// core's cache (HITM), the direct measure of coherence traffic, so it is
+// taken as a raw PMU encoding from BRING_PERF_HITM, e.g.
+//   BRING_PERF_HITM=0x04d2   Intel Skylake to Ice Lake server,
+//                            MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM
+// Look the encoding up for the machine at hand (perf list --details)
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bring_bench {
+
+// Set from main() when --perf_counters is given
+inline bool &perf_counters_enabled() {
+  static bool enabled = false;
+  return enabled;
+}
+
+// Removes --perf_counters from argv, before the benchmark library sees it
+inline void parse_perf_flag(int &argc, char **argv) {
+  int kept = 1;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string_view(argv[i]) == "--perf_counters") {
+      perf_counters_enabled() = true;
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  argc = kept;
+}
+
+struct PerfReading {
+  std::string name;
+  double value;
+};
+
+#if defined(__linux__)
+
+struct PerfEvent {
+  const char *name;
+  uint32_t type;
+  uint64_t config;
+};
+
+namespace detail {
+
+constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+inline std::vector<PerfEvent> perf_events() {
+  std::vector<PerfEvent> events{
+      {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {"l1d_misses", PERF_TYPE_HW_CACHE,
+       cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                   PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      {"llc_misses", PERF_TYPE_HW_CACHE,
+       cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                   PERF_COUNT_HW_CACHE_RESULT_MISS)},
+  };
+  // NOLINTNEXTLINE(concurrency-mt-unsafe)
+  if (const char *hitm = std::getenv("BRING_PERF_HITM"); hitm != nullptr) {
+    events.push_back({"hitm", PERF_TYPE_RAW, std::strtoull(hitm, nullptr, 0)});
+  }
+  return events;
+}
+
+inline int open_event(const PerfEvent &event, int group) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.disabled = group == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group,
+                                  PERF_FLAG_FD_CLOEXEC));
+}
+
+} // namespace detail
+
+// One counter group for the calling thread. Open it, start() and stop()
+// around the measured code from the same thread, then read()
+class PerfCounters {
+  std::vector<int> _fds;
+  std::vector<const char *> _names;
+
+public:
+  PerfCounters() {
+    if (!perf_counters_enabled()) {
+      return;
+    }
+    for (const PerfEvent &event : detail::perf_events()) {
+      const int fd =
+          detail::open_event(event, _fds.empty() ? -1 : _fds.front());
+      if (fd >= 0) {
+        _fds.push_back(fd);
+        _names.push_back(event.name);
+      }
+    }
+  }
+
+  ~PerfCounters() {
+    for (const int fd : _fds) {
+      close(fd);
+    }
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+  PerfCounters(PerfCounters &&) = delete;
+  PerfCounters &operator=(PerfCounters &&) = delete;
+
+  void start() noexcept {
+    if (!_fds.empty()) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+      ioctl(_fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+      ioctl(_fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  void stop() noexcept {
+    if (!_fds.empty()) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+      ioctl(_fds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  // Counts since start(), scaled up if the kernel multiplexed the group
+  [[nodiscard]] std::vector<PerfReading> read() const {
+    std::vector<PerfReading> readings;
+    if (_fds.empty()) {
+      return readings;
+    }
+    // nr, time_enabled, time_running, then one value per event
+    std::vector<uint64_t> buffer(3 + _fds.size());
+    const auto bytes = static_cast<ssize_t>(buffer.size() * sizeof(uint64_t));
+    if (::read(_fds.front(), buffer.data(), buffer.size() * sizeof(uint64_t)) !=
+            bytes ||
+        buffer.at(2) == 0) {
+      return readings;
+    }
+    const double scale =
+        static_cast<double>(buffer.at(1)) / static_cast<double>(buffer.at(2));
+    for (size_t i = 0; i < _fds.size(); ++i) {
+      readings.push_back(
+          {_names.at(i), static_cast<double>(buffer.at(3 + i)) * scale});
+    }
+    return readings;
+  }
+};
+
+#else
+
+class PerfCounters {
+public:
+  static void start() noexcept {}
+  static void stop() noexcept {}
+  [[nodiscard]] static std::vector<PerfReading> read() { return {}; }
+};
+
+#endif
+
+// Adds each reading to the benchmark's counters as <prefix>_<event>,
+// divided by `operations`
+inline void report_perf(benchmark::State &state,
+                        const std::vector<PerfReading> &readings,
+                        std::string_view prefix, double operations) {
+  if (operations <= 0) {
+    return;
+  }
+  for (const PerfReading &reading : readings) {
+    state.counters[std::string(prefix) + "_" + reading.name] =
+        benchmark::Counter(reading.value / operations);
+  }
+}
+
+} // namespace bring_bench
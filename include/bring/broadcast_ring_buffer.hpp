@@ -0,0 +1,194 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace bring {
+
+// Single-producer ring where every one of Readers consumers sees every
+// element, in the style of the LMAX disruptor.
+//
+// Each reader has its own tail cursor and reads elements in place through a
+// const reference, so one published element serves all readers without
+// copies. The producer may only reuse a slot once the slowest reader has
+// moved past it. Elements are destroyed lazily, when the producer next scans
+// the reader cursors or when the ring is destroyed.
+//
+// Reader ids run from 0 to Readers - 1. Each id must be used by at most one
+// thread at a time
+template <RingElement T, size_t Capacity, size_t Readers>
+class BroadcastRingBuffer {
+  static_assert(Readers > 0, "BroadcastRingBuffer needs at least one reader");
+
+  using Extent = StaticCapacity<Capacity>;
+  using Slot = detail::Slot<T>;
+
+  static constexpr size_t mask{Extent::mask()};
+
+  // Prevent false sharing, as in RingBuffer. The producer reads every tail
+  // when it refreshes its cached minimum, so each tail gets its own line, and
+  // each reader's cached head is kept off the line the producer scans
+  static constexpr size_t align_size{64};
+
+  struct ReaderCursor {
+    alignas(align_size) std::atomic<size_t> _tail{0};
+    alignas(align_size) size_t _cached_head{0};
+  };
+
+  alignas(align_size) std::atomic<size_t> _head{0};
+  size_t _cached_min_tail{0}; // producer only
+
+  alignas(align_size) std::array<ReaderCursor, Readers> _readers;
+
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  alignas(align_size) std::unique_ptr<Slot[]> _storage;
+
+  T *get_ptr(size_t idx) noexcept { return _storage[idx & mask].get(); }
+
+  [[nodiscard]] size_t min_tail() const noexcept {
+    size_t slowest = _readers[0]._tail.load(std::memory_order_acquire);
+    for (size_t i = 1; i < Readers; ++i) {
+      slowest = std::min(slowest,
+                         _readers[i]._tail.load(std::memory_order_acquire));
+    }
+    return slowest;
+  }
+
+  // Only rescans the reader cursors when the cached minimum says full.
+  // Elements in [_cached_min_tail, head) are alive; the ones every reader has
+  // moved past are destroyed here, when the producer learns about it
+  [[nodiscard]] bool producer_has_room(size_t current_head) noexcept {
+    if (current_head - _cached_min_tail < Capacity) {
+      return true;
+    }
+    const size_t slowest = min_tail();
+    for (; _cached_min_tail < slowest; ++_cached_min_tail) {
+      get_ptr(_cached_min_tail)->~T();
+    }
+    return current_head - _cached_min_tail < Capacity;
+  }
+
+  // Number of published elements this reader has not seen, reloading the
+  // shared head only when the cached one cannot satisfy `wanted`
+  [[nodiscard]] size_t reader_available(ReaderCursor &cursor, size_t tail,
+                                        size_t wanted) noexcept {
+    size_t available = cursor._cached_head - tail;
+    if (available < wanted) {
+      cursor._cached_head = _head.load(std::memory_order_acquire);
+      available = cursor._cached_head - tail;
+    }
+    return available;
+  }
+
+public:
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  BroadcastRingBuffer() : _storage(std::make_unique<Slot[]>(Capacity)) {}
+
+  ~BroadcastRingBuffer() {
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    for (size_t i = _cached_min_tail; i < current_head; ++i) {
+      get_ptr(i)->~T();
+    }
+  }
+
+  BroadcastRingBuffer(const BroadcastRingBuffer &) = delete;
+  BroadcastRingBuffer &operator=(const BroadcastRingBuffer &) = delete;
+  BroadcastRingBuffer(BroadcastRingBuffer &&) = delete;
+  BroadcastRingBuffer &operator=(BroadcastRingBuffer &&) = delete;
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+  [[nodiscard]] static constexpr size_t readers() noexcept { return Readers; }
+
+  // Elements reader `id` has not consumed yet. Exact from that reader's
+  // thread or the producer's
+  [[nodiscard]] size_t size(size_t id) const noexcept {
+    const size_t current_tail =
+        _readers[id]._tail.load(std::memory_order_acquire);
+    const size_t current_head = _head.load(std::memory_order_acquire);
+    return std::min(current_head - current_tail, Capacity);
+  }
+
+  [[nodiscard]] bool is_empty(size_t id) const noexcept {
+    return size(id) == 0;
+  }
+
+  // True if the slowest reader is a full lap behind the producer
+  [[nodiscard]] bool is_full() const noexcept {
+    return _head.load(std::memory_order_acquire) - min_tail() >= Capacity;
+  }
+
+  // Producer operations. Only one thread may call these
+
+  template <typename... Args>
+    requires std::constructible_from<T, Args...>
+  bool emplace(Args &&...args) {
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    if (!producer_has_room(current_head)) {
+      return false;
+    }
+
+    new (get_ptr(current_head)) T(std::forward<Args>(args)...);
+    _head.store(current_head + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename U>
+    requires std::convertible_to<U, T>
+  bool try_push(U &&item) {
+    return emplace(std::forward<U>(item));
+  }
+
+  // Reader operations. Each id may only be used from one thread
+
+  // Passes the next element to processor(const T&) in place
+  template <typename Func> bool try_consume(size_t id, Func &&processor) {
+    ReaderCursor &cursor = _readers[id];
+    const size_t current_tail = cursor._tail.load(std::memory_order_relaxed);
+    if (reader_available(cursor, current_tail, 1) == 0) {
+      return false;
+    }
+
+    std::forward<Func>(processor)(std::as_const(*get_ptr(current_tail)));
+    cursor._tail.store(current_tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Passes up to max elements to processor(const T&) and advances this
+  // reader's cursor once for the whole batch. If the processor throws, the
+  // elements it already finished stay consumed
+  template <typename Func>
+  size_t consume_n(size_t id, size_t max, Func &&processor) {
+    ReaderCursor &cursor = _readers[id];
+    const size_t current_tail = cursor._tail.load(std::memory_order_relaxed);
+    const size_t count =
+        std::min(reader_available(cursor, current_tail, max), max);
+
+    size_t done = 0;
+    try {
+      for (; done < count; ++done) {
+        processor(std::as_const(*get_ptr(current_tail + done)));
+      }
+    } catch (...) {
+      cursor._tail.store(current_tail + done, std::memory_order_release);
+      throw;
+    }
+    cursor._tail.store(current_tail + count, std::memory_order_release);
+    return count;
+  }
+
+  [[nodiscard]] std::optional<T> try_pop(size_t id)
+    requires std::copy_constructible<T>
+  {
+    std::optional<T> result;
+    try_consume(id, [&result](const T &item) { result.emplace(item); });
+    return result;
+  }
+};
+
+} // namespace bring
@@ -0,0 +1,235 @@
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace bring {
+
+// SPSC ring of variable-length byte records, for messages whose size varies
+// too much to give every slot the worst case.
+//
+// Records are stored contiguously, each behind an 8-byte header holding its
+// length, and padded so every record starts 8-byte aligned. A record never
+// wraps: when one does not fit before the end of the buffer, the producer
+// fills the rest of the buffer with a padding record, which the consumer
+// skips, and starts again at offset 0. head and tail are free-running byte
+// offsets with the same cached-index protocol as RingBuffer.
+//
+// Capacity is in bytes. The largest record is max_record_size() bytes, but a
+// record larger than half the capacity may have to wait for the consumer to
+// drain most of the ring before it fits
+template <size_t Capacity> class ByteRingBuffer {
+  using Extent = StaticCapacity<Capacity>;
+
+  static constexpr size_t align_size{64};
+  static constexpr size_t record_align{8};
+  static_assert(Capacity >= align_size,
+                "ByteRingBuffer capacity must be at least 64 bytes");
+  // Record headers store lengths, including a padding record's, in 32 bits
+  static_assert(Capacity <= std::numeric_limits<uint32_t>::max(),
+                "ByteRingBuffer capacity must fit in 32 bits");
+
+  enum : uint32_t { data_record = 0, padding_record = 1 };
+
+  struct RecordHeader {
+    uint32_t length; // payload bytes, or the bytes skipped by a padding record
+    uint32_t kind;
+  };
+  static constexpr size_t header_size{sizeof(RecordHeader)};
+  static_assert(header_size % record_align == 0);
+
+  struct AlignedDelete {
+    void operator()(std::byte *ptr) const noexcept {
+      ::operator delete[](ptr, std::align_val_t{align_size});
+    }
+  };
+
+  alignas(align_size) std::atomic<size_t> _head{0};
+  size_t _cached_tail{0}; // producer only
+  size_t _reserved{0};    // producer only, payload bytes of the last reserve()
+
+  alignas(align_size) std::atomic<size_t> _tail{0};
+  size_t _cached_head{0}; // consumer only
+  size_t _peeked{0};      // consumer only, record bytes of the last peek()
+
+  alignas(align_size) std::unique_ptr<std::byte[], AlignedDelete> _buffer{
+      static_cast<std::byte *>(
+          ::operator new[](Capacity, std::align_val_t{align_size}))};
+
+  [[nodiscard]] static constexpr size_t record_size(size_t payload) noexcept {
+    return (header_size + payload + record_align - 1) & ~(record_align - 1);
+  }
+
+  std::byte *at(size_t offset) noexcept {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return _buffer.get() + (offset & Extent::mask());
+  }
+
+  void write_header(size_t offset, size_t length, uint32_t kind) noexcept {
+    const RecordHeader header{static_cast<uint32_t>(length), kind};
+    std::memcpy(at(offset), &header, header_size);
+  }
+
+  [[nodiscard]] RecordHeader read_header(size_t offset) noexcept {
+    RecordHeader header{};
+    std::memcpy(&header, at(offset), header_size);
+    return header;
+  }
+
+  // Producer side: true if `bytes` more bytes fit after current_head. The
+  // shared tail is only loaded when the cached copy says they do not
+  [[nodiscard]] bool producer_fits(size_t current_head, size_t bytes) noexcept {
+    if (Capacity - (current_head - _cached_tail) >= bytes) {
+      return true;
+    }
+    _cached_tail = _tail.load(std::memory_order_acquire);
+    return Capacity - (current_head - _cached_tail) >= bytes;
+  }
+
+public:
+  ByteRingBuffer() = default;
+  ~ByteRingBuffer() = default;
+
+  ByteRingBuffer(const ByteRingBuffer &) = delete;
+  ByteRingBuffer &operator=(const ByteRingBuffer &) = delete;
+  ByteRingBuffer(ByteRingBuffer &&) = delete;
+  ByteRingBuffer &operator=(ByteRingBuffer &&) = delete;
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+  [[nodiscard]] static constexpr size_t max_record_size() noexcept {
+    return Capacity - header_size;
+  }
+
+  // Bytes taken by records, headers and padding. A snapshot when called from
+  // a third thread
+  [[nodiscard]] size_t size_bytes() const noexcept {
+    const size_t current_tail = _tail.load(std::memory_order_acquire);
+    const size_t current_head = _head.load(std::memory_order_acquire);
+    return current_head - current_tail;
+  }
+
+  [[nodiscard]] bool is_empty() const noexcept { return size_bytes() == 0; }
+
+  // Producer operations. Only one thread may call these
+
+  // Contiguous, 8-byte aligned space for a record of `bytes` payload bytes,
+  // or an empty span if it does not fit right now. Fill it, then publish it
+  // with commit(). Throws std::invalid_argument if bytes is 0 or larger than
+  // max_record_size(). Drops any earlier reservation that was not committed,
+  // whether or not this one succeeds
+  [[nodiscard]] std::span<std::byte> reserve(size_t bytes) {
+    // The wrap below can move the head past an earlier reservation, so a
+    // stale one must never reach commit()
+    _reserved = 0;
+    if (bytes == 0 || bytes > max_record_size()) {
+      throw std::invalid_argument(
+          "ByteRingBuffer: record size must be in [1, max_record_size()]");
+    }
+    const size_t total = record_size(bytes);
+    size_t current_head = _head.load(std::memory_order_relaxed);
+    const size_t to_end = Capacity - (current_head & Extent::mask());
+    if (to_end < total) {
+      // Skip the rest of the buffer. The padding is published on its own, so
+      // its space comes back as soon as the consumer passes it
+      if (!producer_fits(current_head, to_end)) {
+        return {};
+      }
+      write_header(current_head, to_end, padding_record);
+      current_head += to_end;
+      _head.store(current_head, std::memory_order_release);
+    }
+    if (!producer_fits(current_head, total)) {
+      return {};
+    }
+    _reserved = bytes;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return {at(current_head) + header_size, bytes};
+  }
+
+  // Publish the first `bytes` bytes of the last reserve() as one record.
+  // commit(0) gives the reservation up without publishing anything, since an
+  // empty record would be indistinguishable from no record to peek(). Throws
+  // std::invalid_argument if bytes is larger than the reserved size, which
+  // is 0 when the last reserve() failed or was already committed
+  void commit(size_t bytes) {
+    if (bytes > _reserved) {
+      throw std::invalid_argument(
+          "ByteRingBuffer: commit larger than the last reserve()");
+    }
+    _reserved = 0;
+    if (bytes == 0) {
+      return;
+    }
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    write_header(current_head, bytes, data_record);
+    _head.store(current_head + record_size(bytes), std::memory_order_release);
+  }
+
+  // Publish the whole last reserve(). A no-op if there is none
+  void commit() { commit(_reserved); }
+
+  // Copies `record` into the ring as one record. False if it does not fit
+  bool try_write(std::span<const std::byte> record) {
+    const std::span<std::byte> space = reserve(record.size());
+    if (space.empty()) {
+      return false;
+    }
+    std::memcpy(space.data(), record.data(), record.size());
+    commit();
+    return true;
+  }
+
+  // Consumer operations. Only one thread may call these
+
+  // Payload of the next record, valid until release(), or an empty span if
+  // there is none. Padding records are skipped and handed back here
+  [[nodiscard]] std::span<const std::byte> peek() noexcept {
+    size_t current_tail = _tail.load(std::memory_order_relaxed);
+    while (true) {
+      if (current_tail == _cached_head) {
+        _cached_head = _head.load(std::memory_order_acquire);
+        if (current_tail == _cached_head) {
+          return {};
+        }
+      }
+      const RecordHeader header = read_header(current_tail);
+      if (header.kind == padding_record) {
+        current_tail += header.length;
+        _tail.store(current_tail, std::memory_order_release);
+        continue;
+      }
+      _peeked = record_size(header.length);
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      return {at(current_tail) + header_size, header.length};
+    }
+  }
+
+  // Hand the record returned by the last peek() back to the producer
+  void release() noexcept {
+    const size_t current_tail = _tail.load(std::memory_order_relaxed);
+    _tail.store(current_tail + _peeked, std::memory_order_release);
+    _peeked = 0;
+  }
+
+  // Passes the next record to processor(std::span<const std::byte>) in place
+  template <typename Func> bool try_consume(Func &&processor) {
+    const std::span<const std::byte> record = peek();
+    if (record.empty()) {
+      return false;
+    }
+    std::forward<Func>(processor)(record);
+    release();
+    return true;
+  }
+};
+
+} // namespace bring
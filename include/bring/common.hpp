@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+
+namespace bring {
+
+template <typename T>
+concept RingElement = std::move_constructible<T> && std::destructible<T>;
+
+// Capacity policies. Both keep the power-of-two mask trick; they only differ in
+// whether the mask is a compile-time constant or a member loaded at runtime
+template <size_t Capacity> struct StaticCapacity {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be power of two");
+  static_assert(Capacity > 1, "Capacity must be greater than 1");
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+  [[nodiscard]] static constexpr size_t mask() noexcept { return Capacity - 1; }
+};
+
+class DynamicCapacity {
+  size_t _mask;
+
+public:
+  explicit DynamicCapacity(size_t capacity) : _mask(capacity - 1) {
+    if (capacity <= 1 || !std::has_single_bit(capacity)) {
+      throw std::invalid_argument(
+          "Capacity must be a power of two greater than 1");
+    }
+  }
+
+  [[nodiscard]] size_t capacity() const noexcept { return _mask + 1; }
+  [[nodiscard]] size_t mask() const noexcept { return _mask; }
+};
+
+namespace detail {
+
+// Raw, correctly aligned storage for one T. Rings construct and destroy the
+// element in place, so a slot never holds a T it did not explicitly build
+template <typename T> struct Slot {
+  alignas(T) std::array<std::byte, sizeof(T)> _data;
+
+  T *get() noexcept {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<T *>(_data.data());
+  }
+};
+
+// Slot with a sequence number for rings where several threads claim slots.
+// The sequence tells whose turn it is: pos when free for the producer that
+// claimed position pos, pos + 1 once that producer published the element
+template <typename T> struct SequencedSlot {
+  std::atomic<size_t> _sequence;
+  Slot<T> _slot;
+};
+
+// Claims the next position of `index` in a ring of SequencedSlots. A slot is
+// ready for the claimer when its sequence equals pos + lag: lag is 0 for
+// producers (slot free) and 1 for consumers (slot published). Returns false
+// without claiming if the slot at `index` is not ready, i.e. the ring is full
+// for producers or empty for consumers
+template <typename T>
+[[nodiscard]] bool claim_sequenced(std::atomic<size_t> &index,
+                                   const SequencedSlot<T> *cells, size_t mask,
+                                   size_t lag, size_t &pos) noexcept {
+  pos = index.load(std::memory_order_relaxed);
+  while (true) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const size_t sequence = cells[pos & mask]._sequence.load(
+        std::memory_order_acquire);
+    const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + lag));
+    if (diff == 0) {
+      // On failure the CAS reloads pos with the current index
+      if (index.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      // Another thread claimed pos already, catch up
+      pos = index.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// True if constructing a T from Args... moves from an rvalue T. Sequenced
+// rings build other elements before claiming, so that a throwing constructor
+// leaves the ring untouched. They move a T rvalue straight into the claimed
+// slot instead: the move would follow the claim anyway, and the caller's
+// object is then only moved from when the push succeeds
+template <typename T, typename... Args>
+inline constexpr bool moves_element_v{false};
+
+template <typename T, typename Arg>
+inline constexpr bool moves_element_v<T, Arg>{std::same_as<Arg, T>};
+
+// Hint that `ptr` will be read soon. Compiles to nothing where the builtin
+// is unavailable
+inline void prefetch(const void *ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(ptr, 0, 3);
+#else
+  static_cast<void>(ptr);
+#endif
+}
+
+} // namespace detail
+} // namespace bring
@@ -0,0 +1,130 @@
+#pragma once
+#include "policy.hpp"
+#include "wait_strategy.hpp"
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+
+namespace bring {
+
+// Default executor for async_push/async_pop: resumes the waiting coroutine
+// directly, inside the push or pop call of the other side that made it ready
+struct InlineResume {
+  void operator()(std::coroutine_handle<> handle) const { handle.resume(); }
+};
+
+namespace detail {
+
+// A suspended async_push/async_pop. Lives in the awaiting coroutine's frame;
+// `resume` hands `handle` to the executor the awaiter was created with.
+// `observed` is the index value the waiter is waiting to see change
+struct CoroutineWaiter {
+  std::coroutine_handle<> handle;
+  void (*resume)(CoroutineWaiter &) noexcept;
+  size_t observed{0};
+};
+
+} // namespace detail
+
+// Wait strategy for rings used from coroutines. It enables the ring's
+// async_push() and async_pop() awaitables; blocking push_wait/pop_wait keep
+// spinning and yielding like SpinYieldWait.
+//
+// SPSC means at most one coroutine can wait on each side, so each side has a
+// single waiter slot on its own cache line. The parking protocol is the one
+// AtomicWait uses: the waiter registers, fences and re-checks the index; the
+// publisher fences and only touches the slot when it sees a waiter. Either
+// the waiter sees the new index and does not suspend, or the publisher sees
+// the waiter and resumes it, exactly once. A ring replaces LineSize with its
+// padding policy's line size
+template <unsigned SpinLimit = 64,
+          size_t LineSize = destructive_interference_size>
+class CoroutineWait {
+  static constexpr size_t align_size{LineSize};
+  alignas(align_size) std::atomic<detail::CoroutineWaiter *> _consumer{nullptr};
+  alignas(align_size) std::atomic<detail::CoroutineWaiter *> _producer{nullptr};
+
+  // True if the coroutine must stay suspended. Once the slot is published
+  // the waiter may be resumed, and its frame destroyed, at any moment, so
+  // `waiter` is only compared by address after the store
+  static bool park(std::atomic<detail::CoroutineWaiter *> &slot,
+                   detail::CoroutineWaiter &waiter,
+                   const std::atomic<size_t> &index, size_t observed) noexcept {
+    detail::CoroutineWaiter *const self = &waiter;
+    waiter.observed = observed;
+    // Release so the publisher's exchange sees the waiter's fields
+    slot.store(self, std::memory_order_release);
+    // Pairs with the fence in wake()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (index.load(std::memory_order_relaxed) == observed) {
+      return true;
+    }
+    // The other side published meanwhile. Take the registration back, unless
+    // it already took it and is about to resume us
+    return slot.exchange(nullptr, std::memory_order_acq_rel) != self;
+  }
+
+  // Called by the only writer of `index`, right after publishing it
+  static void wake(std::atomic<detail::CoroutineWaiter *> &slot,
+                   const std::atomic<size_t> &index) noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (slot.load(std::memory_order_relaxed) == nullptr) {
+      return;
+    }
+    detail::CoroutineWaiter *waiter =
+        slot.exchange(nullptr, std::memory_order_acq_rel);
+    if (waiter == nullptr) {
+      return;
+    }
+    // The slot can be reused between the load and the exchange: the old
+    // waiter takes itself back and the same coroutine registers again,
+    // already having seen this publication. Put such a waiter back instead
+    // of resuming it with nothing to do. Only this thread moves the index
+    // and the waiter only takes itself back when the index moved, so nobody
+    // touches the slot in between
+    if (index.load(std::memory_order_relaxed) == waiter->observed) {
+      slot.store(waiter, std::memory_order_release);
+      return;
+    }
+    waiter->resume(*waiter);
+  }
+
+public:
+  using policy_kind = policy_kind::wait;
+  template <size_t Line> using padded = CoroutineWait<SpinLimit, Line>;
+
+  static void pause(unsigned &attempt) noexcept {
+    SpinYieldWait<SpinLimit>::pause(attempt);
+  }
+
+  static void wait_for_data(const std::atomic<size_t> & /*head*/,
+                            size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+  static void wait_for_space(const std::atomic<size_t> & /*tail*/,
+                             size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+
+  // Called from the awaitables' await_suspend: true if the coroutine must
+  // suspend, false if the index moved past `observed` in the meantime
+  bool suspend_for_data(detail::CoroutineWaiter &waiter,
+                        const std::atomic<size_t> &head,
+                        size_t observed) noexcept {
+    return park(_consumer, waiter, head, observed);
+  }
+  bool suspend_for_space(detail::CoroutineWaiter &waiter,
+                         const std::atomic<size_t> &tail,
+                         size_t observed) noexcept {
+    return park(_producer, waiter, tail, observed);
+  }
+
+  void notify_data(std::atomic<size_t> &head) noexcept {
+    wake(_consumer, head);
+  }
+  void notify_space(std::atomic<size_t> &tail) noexcept {
+    wake(_producer, tail);
+  }
+};
+
+} // namespace bring
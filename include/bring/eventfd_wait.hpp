@@ -0,0 +1,170 @@
+#pragma once
+#include "policy.hpp"
+#include "wait_strategy.hpp"
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#if !defined(__linux__)
+#error "bring/eventfd_wait.hpp requires Linux eventfd"
+#endif
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace bring {
+
+// Wait strategy for consumers driven by an event loop (epoll, io_uring,
+// libuv). The ring's native_handle() is a non-blocking eventfd that becomes
+// readable when the producer publishes while the consumer is asleep.
+//
+// The consumer declares itself asleep with the ring's arm_notification()
+// before going back to its loop. The producer only writes the eventfd when
+// it sees that flag, and clears it, so a busy ring makes no syscalls and a
+// sleeping consumer gets one write per sleep. Arming sets the flag, fences
+// and re-checks the ring, like AtomicWait's parking, so a publish cannot be
+// missed between the consumer's last pop and the flag store.
+//
+// Blocking pop_wait spins SpinLimit times and then sleeps in poll() on the
+// same descriptor, with a timeout for pop_wait_for/pop_wait_until; push_wait
+// spins and yields like SpinYieldWait. Throws
+// std::system_error from the constructor if the eventfd cannot be created.
+// A ring replaces LineSize with its padding policy's line size
+template <unsigned SpinLimit = 64,
+          size_t LineSize = destructive_interference_size>
+class EventFdWait {
+  static constexpr size_t align_size{LineSize};
+  // Written by the consumer, read by the producer on every publish
+  alignas(align_size) std::atomic<bool> _consumer_sleeping{false};
+  // Read-only after construction
+  alignas(align_size) int _fd;
+
+public:
+  using policy_kind = policy_kind::wait;
+  template <size_t Line> using padded = EventFdWait<SpinLimit, Line>;
+
+  EventFdWait() : _fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    if (_fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+  }
+
+  ~EventFdWait() {
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+  }
+
+  EventFdWait(const EventFdWait &) = delete;
+  EventFdWait &operator=(const EventFdWait &) = delete;
+
+  // A ring takes its source's descriptor when moved; the moved-from ring is
+  // left without one and must not be waited on
+  EventFdWait(EventFdWait &&other) noexcept
+      : _fd(std::exchange(other._fd, -1)) {}
+  EventFdWait &operator=(EventFdWait &&other) noexcept {
+    if (this != &other) {
+      if (_fd >= 0) {
+        ::close(_fd);
+      }
+      _fd = std::exchange(other._fd, -1);
+      _consumer_sleeping.store(false, std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+  [[nodiscard]] int native_handle() const noexcept { return _fd; }
+
+  // Consumer: declare the consumer asleep unless the ring moved past
+  // `observed` (the consumer's tail) in the meantime. False means data is
+  // already there and the consumer should keep draining instead of sleeping
+  [[nodiscard]] bool arm(const std::atomic<size_t> &head,
+                         size_t observed) noexcept {
+    _consumer_sleeping.store(true, std::memory_order_relaxed);
+    // Pairs with the fence in notify_data()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (head.load(std::memory_order_relaxed) != observed) {
+      _consumer_sleeping.store(false, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  // Consumer: reset the eventfd after it was reported readable
+  void acknowledge() const noexcept {
+    uint64_t count = 0;
+    // Fails with EAGAIN if it was already reset; nothing to do then
+    [[maybe_unused]] const ssize_t ignored = ::read(_fd, &count, sizeof(count));
+  }
+
+  static void pause(unsigned &attempt) noexcept {
+    SpinYieldWait<SpinLimit>::pause(attempt);
+  }
+
+  void wait_for_data(const std::atomic<size_t> &head, size_t observed,
+                     unsigned &attempt) noexcept {
+    if (attempt < SpinLimit) {
+      cpu_relax();
+      ++attempt;
+      return;
+    }
+    if (arm(head, observed)) {
+      pollfd readable{_fd, POLLIN, 0};
+      // Any return is fine: the ring re-checks and calls us again
+      ::poll(&readable, 1, -1);
+      acknowledge();
+    }
+  }
+
+  // poll() counts whole milliseconds, so the sleep is rounded up and may
+  // end just past the deadline
+  template <typename Clock, typename Duration>
+  void wait_for_data_until(
+      const std::atomic<size_t> &head, size_t observed, unsigned &attempt,
+      const std::chrono::time_point<Clock, Duration> &deadline) {
+    if (attempt < SpinLimit) {
+      cpu_relax();
+      ++attempt;
+      return;
+    }
+    if (!arm(head, observed)) {
+      return;
+    }
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - Clock::now());
+    pollfd readable{_fd, POLLIN, 0};
+    ::poll(&readable, 1,
+           static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(
+               remaining.count(), 0, INT_MAX)));
+    // Disarm in case the timeout ended the sleep. A producer that took the
+    // flag first still writes; that wakeup is then spurious
+    _consumer_sleeping.store(false, std::memory_order_relaxed);
+    acknowledge();
+  }
+
+  static void wait_for_space(const std::atomic<size_t> & /*tail*/,
+                             size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+
+  void notify_data(std::atomic<size_t> & /*head*/) noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_consumer_sleeping.load(std::memory_order_relaxed) &&
+        _consumer_sleeping.exchange(false, std::memory_order_relaxed)) {
+      const uint64_t one = 1;
+      // Only fails if the counter would overflow, i.e. it is already readable
+      [[maybe_unused]] const ssize_t ignored = ::write(_fd, &one, sizeof(one));
+    }
+  }
+
+  static void notify_space(std::atomic<size_t> & /*tail*/) noexcept {}
+};
+
+} // namespace bring
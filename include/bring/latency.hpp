@@ -0,0 +1,250 @@
+#pragma once
+#include "padding.hpp"
+#include "policy.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace bring {
+
+// Cheapest monotonic tick counter of the target: the TSC on x86, the
+// virtual counter on AArch64, steady_clock elsewhere. Ticks are only
+// comparable within one machine; see measure_ticks_per_ns()
+[[nodiscard]] inline uint64_t read_ticks() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks = 0;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Ticks of read_ticks() per nanosecond, measured against steady_clock over
+// `window`. Blocks the caller for that long
+[[nodiscard]] inline double measure_ticks_per_ns(
+    std::chrono::milliseconds window = std::chrono::milliseconds(100)) {
+  const auto start_time = std::chrono::steady_clock::now();
+  const uint64_t start_ticks = read_ticks();
+  std::this_thread::sleep_for(window);
+  const uint64_t elapsed_ticks = read_ticks() - start_ticks;
+  const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_time);
+  return static_cast<double>(elapsed_ticks) /
+         static_cast<double>(elapsed_ns.count());
+}
+
+// Log-linear histogram of tick counts: exact below 2^SubBits, then every
+// power of two is split into 2^SubBits linear sub-buckets, so a recorded
+// value is off by at most 2^-SubBits. Values are clamped to 48 bits.
+//
+// One thread records; any thread may read. Buckets are single-writer
+// relaxed atomics, so recording is a load and a store per counter and a
+// reader sees each counter as of some recent moment, not a consistent cut
+// across all of them
+template <unsigned SubBits> class BasicLatencyHistogram {
+  static_assert(SubBits > 0 && SubBits < 16,
+                "BasicLatencyHistogram needs 1 to 15 sub-bucket bits");
+  static constexpr unsigned sub_bits{SubBits};
+  static constexpr unsigned value_bits{48};
+  static constexpr uint64_t sub_count{uint64_t{1} << sub_bits};
+  static constexpr uint64_t max_value{(uint64_t{1} << value_bits) - 1};
+  static constexpr size_t bucket_count{sub_count *
+                                       (value_bits - sub_bits + 1)};
+
+  std::array<std::atomic<uint64_t>, bucket_count> _counts{};
+  std::atomic<uint64_t> _total{0};
+  std::atomic<uint64_t> _max{0};
+
+  static void bump(std::atomic<uint64_t> &counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static size_t index_of(uint64_t value) noexcept {
+    if (value < sub_count) {
+      return static_cast<size_t>(value);
+    }
+    const unsigned exponent = std::bit_width(value) - 1;
+    const unsigned shift = exponent - sub_bits;
+    const uint64_t sub = (value >> shift) - sub_count;
+    return static_cast<size_t>(sub_count * (shift + 1) + sub);
+  }
+
+  // Largest value that maps to bucket `index`
+  [[nodiscard]] static uint64_t upper_bound_of(size_t index) noexcept {
+    if (index < sub_count) {
+      return index;
+    }
+    const uint64_t shift = (index / sub_count) - 1;
+    const uint64_t sub = index % sub_count;
+    return ((sub_count + sub + 1) << shift) - 1;
+  }
+
+public:
+  // Writer only
+  void record(uint64_t ticks) noexcept {
+    const uint64_t value = std::min(ticks, max_value);
+    bump(_counts.at(index_of(value)));
+    bump(_total);
+    if (value > _max.load(std::memory_order_relaxed)) {
+      _max.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] uint64_t count() const noexcept {
+    return _total.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint64_t max() const noexcept {
+    return _max.load(std::memory_order_relaxed);
+  }
+
+  // Smallest bucket bound that at least `quantile` of the samples fall
+  // under, 0 if nothing was recorded
+  [[nodiscard]] uint64_t percentile(double quantile) const noexcept {
+    uint64_t total = 0;
+    for (const std::atomic<uint64_t> &counter : _counts) {
+      total += counter.load(std::memory_order_relaxed);
+    }
+    const auto wanted =
+        static_cast<uint64_t>(quantile * static_cast<double>(total));
+    const uint64_t highest = max();
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+      seen += _counts.at(i).load(std::memory_order_relaxed);
+      if (seen > wanted || (seen == total && total != 0)) {
+        return std::min(upper_bound_of(i), highest);
+      }
+    }
+    return highest;
+  }
+};
+
+// Histogram of LatencySampling: 16 sub-buckets, within 1/16 of each value
+using LatencyHistogram = BasicLatencyHistogram<4>;
+
+// Latency policies see the positions of the elements each side publishes:
+//   on_push(first, n) - producer, before positions [first, first + n) are
+//                       made visible to the consumer
+//   on_pop(first, n)  - consumer, after it read positions [first, first + n)
+//                       and before it hands their slots back
+
+// Default. Both hooks are empty inline functions, so the calls compile away
+struct NoLatencySampling {
+  using policy_kind = policy_kind::latency;
+
+  static void on_push(size_t /*first*/, size_t /*count*/) noexcept {}
+  static void on_pop(size_t /*first*/, size_t /*count*/) noexcept {}
+};
+
+// Samples the time elements spend in the ring. Every position that is a
+// multiple of Every is stamped with read_ticks() when it is pushed, in a
+// side array of Slots entries, and the consumer records now - stamp into a
+// LatencyHistogram when it pops that position. Since both sides know the
+// positions, an unsampled push or pop costs one xor and one compare.
+//
+// The dwell time is the enqueue-to-dequeue delay only: it does not include
+// how long the consumer takes to process an element. Each entry packs 48
+// bits of stamp with the 15 low bits of the position's sample number and a
+// valid bit, so the consumer ignores an entry that a later sample reused
+// before it got there (a ring more than Every * Slots deep) or that was
+// never written. Entries are relaxed atomics written before the producer's
+// release store of the head, which orders them for the consumer.
+//   Every - sample interval, a power of two
+//   Slots - side array entries, a power of two; Every * Slots at or above
+//           the ring capacity keeps every sample
+//   LineSize - spacing of the two sides' state; a ring replaces it with its
+//              padding policy's line size
+template <size_t Every = 1024, size_t Slots = 64,
+          size_t LineSize = destructive_interference_size>
+class LatencySampling {
+  static_assert(Every > 0 && (Every & (Every - 1)) == 0,
+                "LatencySampling interval must be a power of two");
+  static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0,
+                "LatencySampling slots must be a power of two");
+
+  static constexpr unsigned stamp_bits{48};
+  static constexpr uint64_t stamp_mask{(uint64_t{1} << stamp_bits) - 1};
+  static constexpr uint64_t valid_bit{uint64_t{1} << 63};
+  static constexpr uint64_t tag_mask{0x7FFF};
+
+  // Written by the producer, read by the consumer, once every Every
+  // elements
+  alignas(LineSize) std::array<std::atomic<uint64_t>, Slots> _stamps{};
+  // Consumer written
+  alignas(LineSize) LatencyHistogram _histogram;
+
+  // True if [first, first + count) contains a multiple of Every
+  [[nodiscard]] static bool sampled(size_t first, size_t count) noexcept {
+    return ((first - 1) ^ (first + count - 1)) >= Every;
+  }
+
+  template <typename Fn>
+  static void for_each_sample(size_t first, size_t count, Fn &&fn) {
+    const size_t end = first + count;
+    for (size_t pos = (first + Every - 1) & ~(Every - 1); pos < end;
+         pos += Every) {
+      fn(pos / Every);
+    }
+  }
+
+  [[nodiscard]] static uint64_t tag_of(size_t sample) noexcept {
+    return valid_bit | ((static_cast<uint64_t>(sample) & tag_mask)
+                        << stamp_bits);
+  }
+
+public:
+  using policy_kind = policy_kind::latency;
+  template <size_t Line> using padded = LatencySampling<Every, Slots, Line>;
+
+  static constexpr size_t every{Every};
+
+  void on_push(size_t first, size_t count) noexcept {
+    if (!sampled(first, count)) [[likely]] {
+      return;
+    }
+    const uint64_t stamp = read_ticks() & stamp_mask;
+    for_each_sample(first, count, [&](size_t sample) {
+      _stamps.at(sample % Slots)
+          .store(tag_of(sample) | stamp, std::memory_order_relaxed);
+    });
+  }
+
+  void on_pop(size_t first, size_t count) noexcept {
+    if (!sampled(first, count)) [[likely]] {
+      return;
+    }
+    const uint64_t now = read_ticks() & stamp_mask;
+    for_each_sample(first, count, [&](size_t sample) {
+      const uint64_t entry =
+          _stamps.at(sample % Slots).load(std::memory_order_relaxed);
+      if ((entry & ~stamp_mask) == tag_of(sample)) {
+        _histogram.record((now - entry) & stamp_mask);
+      }
+    });
+  }
+
+  // Dwell times in read_ticks() ticks. Safe to read from any thread
+  [[nodiscard]] const LatencyHistogram &histogram() const noexcept {
+    return _histogram;
+  }
+};
+
+} // namespace bring
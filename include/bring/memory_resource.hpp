@@ -0,0 +1,204 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "bring/memory_resource.hpp requires mmap"
+#endif
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace bring {
+
+enum class PageSize {
+  Default,     // the system page size, usually 4 KiB
+  Transparent, // 2 MiB aligned mapping with madvise(MADV_HUGEPAGE) (Linux)
+  Huge2M,      // MAP_HUGETLB 2 MiB pages from the reserved pool (Linux)
+  Huge1G,      // MAP_HUGETLB 1 GiB pages from the reserved pool (Linux)
+};
+
+struct MappedMemoryOptions {
+  PageSize pages{PageSize::Default};
+  // Bind the memory to this NUMA node with mbind(MPOL_BIND) (Linux)
+  std::optional<int> numa_node;
+  // Touch every page in allocate(), after NUMA binding, so the ring's first
+  // lap does not take page faults
+  bool prefault{false};
+};
+
+// memory_resource that gives every allocation its own anonymous mmap, for use
+// with ResourceStorage. Meant for a few large, long-lived allocations such as
+// ring slot arrays, not for general purpose use.
+//
+// allocate() throws std::bad_alloc if the mapping fails, e.g. when no huge
+// pages are reserved for Huge2M/Huge1G, and std::system_error if NUMA binding
+// fails. Options the platform cannot honour throw std::invalid_argument from
+// the constructor
+class MappedMemoryResource : public std::pmr::memory_resource {
+  static constexpr size_t huge_2m{size_t{1} << 21};
+  static constexpr size_t huge_1g{size_t{1} << 30};
+
+  MappedMemoryOptions _options;
+  size_t _page_size;
+
+  [[nodiscard]] static size_t system_page_size() noexcept {
+    return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  }
+
+  [[nodiscard]] size_t rounded(size_t bytes) const noexcept {
+    return (bytes + _page_size - 1) / _page_size * _page_size;
+  }
+
+  // Maps `size` bytes aligned to `alignment` by over-mapping and trimming the
+  // unaligned head and tail
+  [[nodiscard]] static void *map_aligned(size_t size, size_t alignment,
+                                         int extra_flags) {
+    const size_t slack = alignment > system_page_size() ? alignment : 0;
+    void *raw = ::mmap(nullptr, size + slack, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    if (raw == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    if (slack == 0) {
+      return raw;
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
+    if (aligned > start) {
+      ::munmap(raw, aligned - start);
+    }
+    const size_t tail = slack - (aligned - start);
+    if (tail > 0) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,performance-no-int-to-ptr)
+      ::munmap(reinterpret_cast<void *>(aligned + size), tail);
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,performance-no-int-to-ptr)
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  void bind_to_node(void *ptr, size_t size, int node) const {
+#if defined(__linux__)
+    constexpr int mpol_bind = 2;
+    constexpr size_t bits_per_word = sizeof(unsigned long) * CHAR_BIT;
+    std::array<unsigned long, 16> nodemask{};
+    const auto node_index = static_cast<size_t>(node);
+    nodemask.at(node_index / bits_per_word) |= 1UL
+                                               << (node_index % bits_per_word);
+    if (::syscall(SYS_mbind, ptr, size, mpol_bind, nodemask.data(),
+                  nodemask.size() * bits_per_word, 0) != 0) {
+      const int saved = errno;
+      ::munmap(ptr, size);
+      throw std::system_error(saved, std::generic_category(), "mbind");
+    }
+#else
+    static_cast<void>(ptr);
+    static_cast<void>(size);
+    static_cast<void>(node);
+#endif
+  }
+
+  // Extra mmap flags for MAP_HUGETLB pages, 0 for the other page sizes
+  [[nodiscard]] int huge_page_flags() const noexcept {
+#if defined(__linux__)
+    if (_options.pages == PageSize::Huge2M ||
+        _options.pages == PageSize::Huge1G) {
+#if defined(MAP_HUGE_SHIFT)
+      const int page_shift = _options.pages == PageSize::Huge2M ? 21 : 30;
+      return MAP_HUGETLB | (page_shift << MAP_HUGE_SHIFT);
+#else
+      return MAP_HUGETLB;
+#endif
+    }
+#endif
+    return 0;
+  }
+
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    const size_t size = rounded(bytes);
+    void *ptr = nullptr;
+    if (const int flags = huge_page_flags(); flags != 0) {
+      // The kernel aligns huge page mappings to the huge page size
+      if (alignment > _page_size) {
+        throw std::bad_alloc();
+      }
+      ptr = map_aligned(size, 0, flags);
+    } else if (_options.pages == PageSize::Transparent) {
+      // Align to the huge page size so the whole range can be backed by them
+      ptr = map_aligned(size, std::max(alignment, huge_2m), 0);
+#if defined(__linux__)
+      // Only a hint; the kernel may still use small pages
+      ::madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    } else {
+      ptr = map_aligned(size, alignment, 0);
+    }
+
+    if (_options.numa_node) {
+      bind_to_node(ptr, size, *_options.numa_node);
+    }
+    if (_options.prefault) {
+      auto *bytes_ptr = static_cast<volatile std::byte *>(ptr);
+      for (size_t offset = 0; offset < size; offset += system_page_size()) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        bytes_ptr[offset] = std::byte{0};
+      }
+    }
+    return ptr;
+  }
+
+  void do_deallocate(void *ptr, size_t bytes, size_t /*alignment*/) override {
+    ::munmap(ptr, rounded(bytes));
+  }
+
+  [[nodiscard]] bool
+  do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+public:
+  explicit MappedMemoryResource(MappedMemoryOptions options = {})
+      : _options(options), _page_size(system_page_size()) {
+#if !defined(__linux__)
+    if (options.pages == PageSize::Huge2M ||
+        options.pages == PageSize::Huge1G) {
+      throw std::invalid_argument("MAP_HUGETLB pages require Linux");
+    }
+    if (options.numa_node) {
+      throw std::invalid_argument("NUMA binding requires Linux");
+    }
+#endif
+    if (options.numa_node &&
+        (*options.numa_node < 0 ||
+         static_cast<size_t>(*options.numa_node) >=
+             16 * sizeof(unsigned long) * CHAR_BIT)) {
+      throw std::invalid_argument("NUMA node out of range");
+    }
+    if (options.pages == PageSize::Huge2M ||
+        options.pages == PageSize::Transparent) {
+      _page_size = huge_2m;
+    } else if (options.pages == PageSize::Huge1G) {
+      _page_size = huge_1g;
+    }
+  }
+
+  [[nodiscard]] const MappedMemoryOptions &options() const noexcept {
+    return _options;
+  }
+};
+
+} // namespace bring
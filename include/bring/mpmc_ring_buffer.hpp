@@ -0,0 +1,159 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace bring {
+
+// Bounded multi-producer multi-consumer queue in the style of Dmitry Vyukov's
+// bounded MPMC queue.
+//
+// Both sides claim positions with a CAS on their own index and coordinate
+// through the per-slot sequence number: pos while the slot is free for the
+// producer claiming pos, pos + 1 once published, pos + Capacity once the
+// consumer has emptied it for the next lap. Producers and consumers only meet
+// on the slot they are handing over, never on each other's index
+template <RingElement T, size_t Capacity> class MpmcRingBuffer {
+  using Extent = StaticCapacity<Capacity>;
+  using Cell = detail::SequencedSlot<T>;
+
+  static constexpr size_t mask{Extent::mask()};
+
+  // Prevent false sharing. Producers contend on head, consumers on tail
+  static constexpr size_t align_size{64};
+  alignas(align_size) std::atomic<size_t> _head{0};
+  alignas(align_size) std::atomic<size_t> _tail{0};
+
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  alignas(align_size) std::unique_ptr<Cell[]> _cells;
+
+  template <typename... Args>
+  static void construct_at_claimed(T *ptr, Args &&...args) noexcept {
+    // A claimed slot must be published or consumers stall on it forever, so
+    // the construction that follows a claim is not allowed to throw
+    new (ptr) T(std::forward<Args>(args)...);
+  }
+
+  // Destroys the element of a claimed slot and hands the slot to the next
+  // lap's producer, also when the consumer's processor throws
+  class ReleaseGuard {
+    Cell &_cell;
+    size_t _pos;
+
+  public:
+    ReleaseGuard(Cell &cell, size_t pos) noexcept : _cell(cell), _pos(pos) {}
+    ReleaseGuard(const ReleaseGuard &) = delete;
+    ReleaseGuard &operator=(const ReleaseGuard &) = delete;
+    ReleaseGuard(ReleaseGuard &&) = delete;
+    ReleaseGuard &operator=(ReleaseGuard &&) = delete;
+
+    ~ReleaseGuard() {
+      _cell._slot.get()->~T();
+      _cell._sequence.store(_pos + Capacity, std::memory_order_release);
+    }
+
+    [[nodiscard]] T &element() noexcept { return *_cell._slot.get(); }
+  };
+
+public:
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  MpmcRingBuffer() : _cells(std::make_unique<Cell[]>(Capacity)) {
+    for (size_t i = 0; i < Capacity; ++i) {
+      _cells[i]._sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~MpmcRingBuffer() {
+    while (try_consume([]([[maybe_unused]] T && /* discard */) {})) {
+    }
+  }
+
+  MpmcRingBuffer(const MpmcRingBuffer &) = delete;
+  MpmcRingBuffer &operator=(const MpmcRingBuffer &) = delete;
+  MpmcRingBuffer(MpmcRingBuffer &&) = delete;
+  MpmcRingBuffer &operator=(MpmcRingBuffer &&) = delete;
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+  // Snapshot of the number of claimed positions. Elements that are being
+  // published or consumed right now are counted, so this is approximate while
+  // other threads run
+  [[nodiscard]] size_t size() const noexcept {
+    const size_t current_tail = _tail.load(std::memory_order_acquire);
+    const size_t current_head = _head.load(std::memory_order_acquire);
+    return current_head > current_tail
+               ? std::min(current_head - current_tail, Capacity)
+               : 0;
+  }
+
+  [[nodiscard]] bool is_full() const noexcept { return size() == Capacity; }
+  [[nodiscard]] bool is_empty() const noexcept { return size() == 0; }
+
+  // All operations are safe to call from any number of threads
+
+  template <typename... Args>
+    requires std::constructible_from<T, Args...>
+  bool emplace(Args &&...args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args...> ||
+                  detail::moves_element_v<T, Args...>) {
+      size_t pos = 0;
+      if (!detail::claim_sequenced(_head, _cells.get(), mask, 0, pos)) {
+        return false;
+      }
+      Cell &cell = _cells[pos & mask];
+      construct_at_claimed(cell._slot.get(), std::forward<Args>(args)...);
+      cell._sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    } else {
+      // Build the element before claiming so a throwing constructor leaves
+      // the queue untouched; only the move into the slot happens after claim.
+      // Rvalues of other types may be moved from even if the queue is full
+      T item(std::forward<Args>(args)...);
+      size_t pos = 0;
+      if (!detail::claim_sequenced(_head, _cells.get(), mask, 0, pos)) {
+        return false;
+      }
+      Cell &cell = _cells[pos & mask];
+      construct_at_claimed(cell._slot.get(), std::move(item));
+      cell._sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+  }
+
+  template <typename U>
+    requires std::convertible_to<U, T>
+  bool try_push(U &&item) {
+    return emplace(std::forward<U>(item));
+  }
+
+  // The element is consumed once claimed: if the processor throws, it is
+  // still destroyed and its slot released
+  template <typename Func> bool try_consume(Func &&processor) {
+    size_t pos = 0;
+    if (!detail::claim_sequenced(_tail, _cells.get(), mask, 1, pos)) {
+      return false;
+    }
+
+    ReleaseGuard guard(_cells[pos & mask], pos);
+    std::forward<Func>(processor)(std::move(guard.element()));
+    return true;
+  }
+
+  [[nodiscard]] std::optional<T> try_pop() {
+    std::optional<T> result;
+    try_consume([&result](T &&item) { result.emplace(std::move(item)); });
+    return result;
+  }
+
+  bool try_pop_ip(T &out) {
+    return try_consume([&out](T &&item) { out = std::move(item); });
+  }
+};
+
+} // namespace bring
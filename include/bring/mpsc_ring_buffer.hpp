@@ -0,0 +1,153 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace bring {
+
+// Bounded multi-producer single-consumer ring with the same API surface as
+// RingBuffer, so the two can be swapped with a type alias.
+//
+// Producers claim a position with a CAS on _head. Every slot carries a
+// sequence number: it equals the position while the slot is free for that
+// lap and position + 1 once the element is published. The consumer never
+// reads _head; it pops with one acquire load of the slot it is about to read
+template <RingElement T, size_t Capacity> class MpscRingBuffer {
+  using Extent = StaticCapacity<Capacity>;
+  using Cell = detail::SequencedSlot<T>;
+
+  static constexpr size_t mask{Extent::mask()};
+
+  // Prevent false sharing. Producers contend on head; tail is only written by
+  // the consumer and kept atomic so other threads can read size()
+  static constexpr size_t align_size{64};
+  alignas(align_size) std::atomic<size_t> _head{0};
+  alignas(align_size) std::atomic<size_t> _tail{0};
+
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  alignas(align_size) std::unique_ptr<Cell[]> _cells;
+
+  // Claims the next free position for this producer. Returns false if the
+  // slot at head still holds the element from the previous lap (ring full)
+  [[nodiscard]] bool claim(size_t &pos) noexcept {
+    return detail::claim_sequenced(_head, _cells.get(), mask, 0, pos);
+  }
+
+  template <typename... Args>
+  static void construct_at_claimed(T *ptr, Args &&...args) noexcept {
+    // A claimed slot must be published or the consumer stalls on it forever,
+    // so the construction that follows a claim is not allowed to throw
+    new (ptr) T(std::forward<Args>(args)...);
+  }
+
+public:
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  MpscRingBuffer() : _cells(std::make_unique<Cell[]>(Capacity)) {
+    for (size_t i = 0; i < Capacity; ++i) {
+      _cells[i]._sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~MpscRingBuffer() {
+    while (try_consume([]([[maybe_unused]] T && /* discard */) {})) {
+    }
+  }
+
+  MpscRingBuffer(const MpscRingBuffer &) = delete;
+  MpscRingBuffer &operator=(const MpscRingBuffer &) = delete;
+  MpscRingBuffer(MpscRingBuffer &&) = delete;
+  MpscRingBuffer &operator=(MpscRingBuffer &&) = delete;
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+  // Snapshot of the number of elements, including ones that producers have
+  // claimed but not finished publishing yet
+  [[nodiscard]] size_t size() const noexcept {
+    const size_t current_tail = _tail.load(std::memory_order_acquire);
+    const size_t current_head = _head.load(std::memory_order_acquire);
+    return std::min(current_head - current_tail, Capacity);
+  }
+
+  [[nodiscard]] bool is_full() const noexcept { return size() == Capacity; }
+
+  // Exact from the consumer thread: true if the next element to pop is not
+  // published yet
+  [[nodiscard]] bool is_empty() const noexcept {
+    const size_t current_tail = _tail.load(std::memory_order_relaxed);
+    return _cells[current_tail & mask]._sequence.load(
+               std::memory_order_acquire) != current_tail + 1;
+  }
+
+  // Producer operations. Safe to call from any number of threads
+
+  template <typename... Args>
+    requires std::constructible_from<T, Args...>
+  bool emplace(Args &&...args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args...> ||
+                  detail::moves_element_v<T, Args...>) {
+      size_t pos = 0;
+      if (!claim(pos)) {
+        return false;
+      }
+      Cell &cell = _cells[pos & mask];
+      construct_at_claimed(cell._slot.get(), std::forward<Args>(args)...);
+      cell._sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    } else {
+      // Build the element before claiming so a throwing constructor leaves
+      // the ring untouched; only the move into the slot happens after claim.
+      // Rvalues of other types may be moved from even if the ring is full
+      T item(std::forward<Args>(args)...);
+      size_t pos = 0;
+      if (!claim(pos)) {
+        return false;
+      }
+      Cell &cell = _cells[pos & mask];
+      construct_at_claimed(cell._slot.get(), std::move(item));
+      cell._sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+  }
+
+  template <typename U>
+    requires std::convertible_to<U, T>
+  bool try_push(U &&item) {
+    return emplace(std::forward<U>(item));
+  }
+
+  // Consumer operations. Only one thread may call these
+
+  template <typename Func> bool try_consume(Func &&processor) {
+    const size_t current_tail = _tail.load(std::memory_order_relaxed);
+    Cell &cell = _cells[current_tail & mask];
+    if (cell._sequence.load(std::memory_order_acquire) != current_tail + 1) {
+      return false;
+    }
+
+    T *element_ptr = cell._slot.get();
+    std::forward<Func>(processor)(std::move(*element_ptr));
+    element_ptr->~T();
+    // Hand the slot to the producer that claims this position next lap
+    cell._sequence.store(current_tail + Capacity, std::memory_order_release);
+    _tail.store(current_tail + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  [[nodiscard]] std::optional<T> try_pop() {
+    std::optional<T> result;
+    try_consume([&result](T &&item) { result.emplace(std::move(item)); });
+    return result;
+  }
+
+  bool try_pop_ip(T &out) {
+    return try_consume([&out](T &&item) { out = std::move(item); });
+  }
+};
+
+} // namespace bring
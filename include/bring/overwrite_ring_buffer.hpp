@@ -0,0 +1,174 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace bring {
+
+// Lossy SPSC ring for telemetry: the producer never waits and never fails,
+// it overwrites the oldest entry when the consumer falls behind. The
+// consumer skips what was overwritten and counts it in lost().
+//
+// Reads are validated seqlock-style. Slot pos & mask holds the entry at
+// position pos until the producer starts writing pos + Capacity, and the
+// producer's free-running head says how far it got, so the head acts as the
+// sequence number of every slot at once. The consumer copies entries out,
+// re-reads the head and throws away the copies the producer may have
+// started overwriting in the meantime. A push is the payload stores plus one
+// store of the head, and the producer never reads anything the consumer
+// writes.
+//
+// Since the slot after the newest entry may be mid-overwrite, at most
+// Capacity - 1 entries are kept. T must be trivially copyable: the consumer
+// copies slots that may be torn and only looks at a copy once it is known to
+// be intact. Slots are stored as relaxed 64-bit atomics so those racing
+// copies are well defined
+template <typename T, size_t Capacity> class OverwriteRingBuffer {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "OverwriteRingBuffer elements must be trivially copyable");
+
+  using Extent = StaticCapacity<Capacity>;
+
+  static constexpr size_t mask{Extent::mask()};
+  static constexpr size_t align_size{64};
+  static constexpr size_t words{(sizeof(T) + sizeof(uint64_t) - 1) /
+                                sizeof(uint64_t)};
+  // Entries copied before each head re-check
+  static constexpr size_t chunk_size{16};
+
+  using Cell = std::array<std::atomic<uint64_t>, words>;
+
+  alignas(align_size) std::atomic<size_t> _head{0};
+
+  // Consumer only
+  alignas(align_size) size_t _tail{0};
+  size_t _lost{0};
+
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  alignas(align_size) std::unique_ptr<Cell[]> _cells;
+
+  // Oldest position that cannot be mid-overwrite when the head is `head`
+  [[nodiscard]] static constexpr size_t oldest_intact(size_t head) noexcept {
+    return head >= Capacity ? head - Capacity + 1 : 0;
+  }
+
+  void read_cell(size_t pos, detail::Slot<T> &out) const noexcept {
+    const Cell &cell = _cells[pos & mask];
+    for (size_t w = 0; w < words; ++w) {
+      const uint64_t word = cell[w].load(std::memory_order_relaxed);
+      const size_t offset = w * sizeof(uint64_t);
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      std::memcpy(out._data.data() + offset, &word,
+                  std::min(sizeof(uint64_t), sizeof(T) - offset));
+    }
+  }
+
+  // Copies up to `max` entries starting at the tail into `out`, after
+  // skipping entries already overwritten. Returns the offset of the first
+  // intact copy and the number of copies; failed copies count as lost
+  [[nodiscard]] std::pair<size_t, size_t>
+  read_chunk(std::array<detail::Slot<T>, chunk_size> &out,
+             size_t max) noexcept {
+    const size_t head = _head.load(std::memory_order_acquire);
+    if (const size_t oldest = oldest_intact(head); _tail < oldest) {
+      _lost += oldest - _tail;
+      _tail = oldest;
+    }
+    const size_t count = std::min({head - _tail, max, chunk_size});
+    for (size_t i = 0; i < count; ++i) {
+      read_cell(_tail + i, out.at(i));
+    }
+    // Pairs with the fence in push(): if a copy saw any store of an
+    // overwrite, this head load sees the head that overwrite started from
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const size_t oldest = oldest_intact(_head.load(std::memory_order_relaxed));
+    const size_t torn =
+        oldest > _tail ? std::min(oldest - _tail, count) : size_t{0};
+    _lost += torn;
+    _tail += count;
+    return {torn, count};
+  }
+
+public:
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  OverwriteRingBuffer() : _cells(std::make_unique<Cell[]>(Capacity)) {}
+
+  ~OverwriteRingBuffer() = default;
+
+  OverwriteRingBuffer(const OverwriteRingBuffer &) = delete;
+  OverwriteRingBuffer &operator=(const OverwriteRingBuffer &) = delete;
+  OverwriteRingBuffer(OverwriteRingBuffer &&) = delete;
+  OverwriteRingBuffer &operator=(OverwriteRingBuffer &&) = delete;
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+  // Producer operations. Only one thread may call these
+
+  // Always succeeds, overwriting the oldest entry if the ring is full
+  void push(const T &item) noexcept {
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    std::array<uint64_t, words> staged{};
+    std::memcpy(staged.data(), &item, sizeof(T));
+    // Orders the previous head store before the payload stores, so a
+    // consumer that sees part of this overwrite also sees it started
+    std::atomic_thread_fence(std::memory_order_release);
+    Cell &cell = _cells[current_head & mask];
+    for (size_t w = 0; w < words; ++w) {
+      cell[w].store(staged.at(w), std::memory_order_relaxed);
+    }
+    _head.store(current_head + 1, std::memory_order_release);
+  }
+
+  // Consumer operations. Only one thread may call these
+
+  // Entries still readable, at most Capacity - 1. Consumer only, since the
+  // tail is not shared
+  [[nodiscard]] size_t size() const noexcept {
+    const size_t head = _head.load(std::memory_order_acquire);
+    return head - std::max(_tail, oldest_intact(head));
+  }
+
+  [[nodiscard]] bool is_empty() const noexcept { return size() == 0; }
+
+  // Entries overwritten before the consumer got to them, since construction
+  [[nodiscard]] size_t lost() const noexcept { return _lost; }
+
+  // Passes up to `max` intact entries, oldest first, to
+  // processor(const T&). Entries lost while reading are skipped and added
+  // to lost(). Returns the number passed to processor
+  template <typename Func> size_t consume_n(size_t max, Func &&processor) {
+    std::array<detail::Slot<T>, chunk_size> copies;
+    size_t done = 0;
+    while (done < max) {
+      const auto [first, count] = read_chunk(copies, max - done);
+      if (count == 0) {
+        break;
+      }
+      for (size_t i = first; i < count; ++i) {
+        processor(std::as_const(*copies.at(i).get()));
+      }
+      done += count - first;
+    }
+    return done;
+  }
+
+  template <typename Func> bool try_consume(Func &&processor) {
+    return consume_n(1, std::forward<Func>(processor)) == 1;
+  }
+
+  [[nodiscard]] std::optional<T> try_pop() {
+    std::optional<T> result;
+    try_consume([&result](const T &item) { result.emplace(item); });
+    return result;
+  }
+};
+
+} // namespace bring
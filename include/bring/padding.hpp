@@ -0,0 +1,108 @@
+#pragma once
+#include "policy.hpp"
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace bring {
+
+// Bytes two objects must be apart so writes to one do not invalidate the
+// other's cache line. std::hardware_destructive_interference_size where the
+// library has it, 64 otherwise. GCC warns that the constant can differ
+// between compiler versions and flags; rings are header-only and never
+// exchanged between translation units built with different settings, so
+// that is fine here
+#if defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+inline constexpr size_t destructive_interference_size{
+    std::hardware_destructive_interference_size};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+inline constexpr size_t destructive_interference_size{64};
+#endif
+
+// Padding policies set the alignment RingBuffer gives each group of fields
+// that one side writes: the head, the producer's cached tail, the tail, the
+// consumer's cached head, and the read-only capacity and storage handle.
+//   line_size - bytes per group, a power of two
+// Wait, stats and latency policies that keep state for both sides take the
+// same line size through a nested `padded<LineSize>` alias, which the ring
+// uses in place of the policy it was given. Policies without one are used
+// as they are
+
+template <size_t LineSize> struct CacheLinePadding {
+  static_assert(LineSize >= alignof(std::max_align_t) &&
+                    (LineSize & (LineSize - 1)) == 0,
+                "CacheLinePadding needs a power of two of at least "
+                "alignof(std::max_align_t)");
+  using policy_kind = policy_kind::padding;
+  static constexpr size_t line_size{LineSize};
+};
+
+// Default. destructive_interference_size for the target
+using InterferencePadding = CacheLinePadding<destructive_interference_size>;
+
+// For Apple M-series cores, which have 128-byte lines, and Intel cores whose
+// adjacent-line prefetcher pulls 64-byte lines in pairs
+using Padding128 = CacheLinePadding<128>;
+
+namespace detail {
+
+template <typename Policy, size_t LineSize> struct padded_policy {
+  using type = Policy;
+};
+
+template <typename Policy, size_t LineSize>
+  requires requires { typename Policy::template padded<LineSize>; }
+struct padded_policy<Policy, LineSize> {
+  using type = typename Policy::template padded<LineSize>;
+};
+
+// Policy with its per-side state spaced LineSize bytes apart
+template <typename Policy, size_t LineSize>
+using padded_policy_t = typename padded_policy<Policy, LineSize>::type;
+
+} // namespace detail
+
+// Byte offsets of a ring's field groups, from BasicRingBuffer::layout()
+struct RingLayout {
+  // Offset of a policy group whose policy keeps no state
+  static constexpr size_t absent{~size_t{0}};
+
+  size_t line_size;
+  size_t head;
+  size_t producer_cache; // cached tail and deferred head
+  size_t tail;
+  size_t consumer_cache; // cached head and deferred tail
+  size_t shared;         // capacity and storage, read-only after construction
+  size_t wait;           // wait strategy state, e.g. AtomicWait's flags
+  size_t stats;          // stats counters
+  size_t latency;        // latency stamps and histogram
+  size_t size;
+
+  // True if no two groups share a line_size-aligned line. Absent groups
+  // are skipped
+  [[nodiscard]] constexpr bool separated() const noexcept {
+    const std::array<size_t, 8> offsets{head,   producer_cache, tail,
+                                        consumer_cache, shared, wait,
+                                        stats,  latency};
+    size_t next_line = 0;
+    for (const size_t offset : offsets) {
+      if (offset == absent) {
+        continue;
+      }
+      if (offset / line_size < next_line) {
+        return false;
+      }
+      next_line = offset / line_size + 1;
+    }
+    return true;
+  }
+};
+
+} // namespace bring
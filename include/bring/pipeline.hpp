@@ -0,0 +1,393 @@
+#pragma once
+#include "ring_buffer.hpp"
+#include "wait_strategy.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <system_error>
+#endif
+
+namespace bring {
+
+// A pipeline stage that runs on its own thread and reads its input from an
+// SPSC ring. Wait is the wait strategy of that ring: it decides how the
+// stage waits for input, and how the stage before it waits for room
+template <typename Func, typename Wait = BusySpinWait> struct Stage {
+  using function_type = Func;
+  using wait_strategy = Wait;
+  static constexpr bool fused{false};
+  static constexpr size_t default_batch{64};
+
+  Func function;
+  std::optional<int> cpu;
+  size_t batch{default_batch};
+
+  // Pin the stage's thread to this CPU when the pipeline starts
+  Stage on_core(int core) && {
+    cpu = core;
+    return std::move(*this);
+  }
+
+  // Most input elements taken from the ring per consume call
+  Stage batch_size(size_t count) && {
+    batch = count;
+    return std::move(*this);
+  }
+
+  template <Policy W> Stage<Func, W> wait() && {
+    return {std::move(function), cpu, batch};
+  }
+};
+
+// A cheap stage run inline on the thread of the stage before it, with no
+// ring hop in between
+template <typename Func> struct FusedStage {
+  using function_type = Func;
+  static constexpr bool fused{true};
+
+  Func function;
+};
+
+template <typename Func> Stage<std::decay_t<Func>> stage(Func &&function) {
+  using Result = Stage<std::decay_t<Func>>;
+  return Result{std::forward<Func>(function), std::nullopt,
+                Result::default_batch};
+}
+
+template <typename Func> FusedStage<std::decay_t<Func>> fused(Func &&function) {
+  return {std::forward<Func>(function)};
+}
+
+struct PipelineStageStats {
+  uint64_t processed;              // elements this stage's function returned
+  std::chrono::nanoseconds blocked; // time its thread waited for input or room
+};
+
+namespace detail {
+
+// Input type of every stage: stage k + 1 takes what stage k returns
+template <typename In, typename Inputs, typename... Stages>
+struct pipeline_inputs {
+  using type = Inputs;
+};
+
+template <typename In, typename... Done, typename S, typename... Rest>
+struct pipeline_inputs<In, std::tuple<Done...>, S, Rest...>
+    : pipeline_inputs<
+          std::invoke_result_t<typename S::function_type &, In &&>,
+          std::tuple<Done..., In>, Rest...> {};
+
+// Written only by the thread that runs the stage
+struct alignas(64) StageCounters {
+  std::atomic<uint64_t> processed{0};
+  std::atomic<int64_t> blocked_ns{0};
+};
+
+inline void bump_counter(std::atomic<uint64_t> &counter) noexcept {
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+}
+
+inline void pin_thread(std::thread &thread, int cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (const int error =
+          pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+      error != 0) {
+    throw std::system_error(error, std::generic_category(),
+                            "pthread_setaffinity_np");
+  }
+#else
+  static_cast<void>(thread);
+  static_cast<void>(cpu);
+  throw std::invalid_argument("Stage core affinity requires Linux");
+#endif
+}
+
+} // namespace detail
+
+// Chain of stages connected by SPSC rings of Capacity elements. Every Stage
+// gets a thread and an input ring; a FusedStage runs on the thread of the
+// stage before it. Stage k is called as function(In_k&&) and returns the
+// input of stage k + 1; the last stage returns void.
+//
+// Each thread drains its ring with consume_up_to() in batches of up to
+// Stage::batch elements and pushes results into the next ring, waiting with
+// that ring's strategy when it is full. End of stream travels through the
+// rings behind the last element, so close() returns once everything pushed
+// before it went through every stage.
+//
+// push() and try_push() feed the first stage and must be called from one
+// thread. If a stage function throws, its thread discards the rest of its
+// input and close() rethrows the first exception. Build with make_pipeline()
+template <typename In, size_t Capacity, typename... Stages> class Pipeline {
+  static constexpr size_t stage_count{sizeof...(Stages)};
+  static_assert(stage_count > 0, "A pipeline needs at least one stage");
+
+  using StageTuple = std::tuple<Stages...>;
+  using Inputs = typename detail::pipeline_inputs<In, std::tuple<>,
+                                                  Stages...>::type;
+
+  template <size_t K> using stage_t = std::tuple_element_t<K, StageTuple>;
+  template <size_t K> using input_t = std::tuple_element_t<K, Inputs>;
+
+  template <size_t K> static constexpr bool is_fused = stage_t<K>::fused;
+  static_assert(!is_fused<0>, "The first stage cannot be fused");
+
+  // In-band message: nullopt marks the end of the stream
+  template <size_t K> using message_t = std::optional<input_t<K>>;
+
+  template <size_t K> struct ring_for {
+    using type = std::monostate;
+  };
+  template <size_t K>
+    requires(!is_fused<K>)
+  struct ring_for<K> {
+    using type = std::unique_ptr<RingBuffer<
+        message_t<K>, Capacity, typename stage_t<K>::wait_strategy>>;
+  };
+
+  template <typename Seq> struct ring_tuple;
+  template <size_t... K> struct ring_tuple<std::index_sequence<K...>> {
+    using type = std::tuple<typename ring_for<K>::type...>;
+  };
+
+  // First threaded stage after K, or stage_count if there is none
+  template <size_t K> static constexpr size_t next_threaded() noexcept {
+    if constexpr (K + 1 >= stage_count) {
+      return stage_count;
+    } else if constexpr (!is_fused<K + 1>) {
+      return K + 1;
+    } else {
+      return next_threaded<K + 1>();
+    }
+  }
+
+  StageTuple _stages;
+  typename ring_tuple<std::make_index_sequence<stage_count>>::type _rings;
+  std::array<detail::StageCounters, stage_count> _counters;
+  std::array<std::exception_ptr, stage_count> _errors;
+  std::array<std::thread, stage_count> _threads;
+  bool _started{false};
+  bool _closed{false};
+
+  template <size_t K> auto &ring() noexcept { return *std::get<K>(_rings); }
+
+  // Time spent in `wait`, added to the blocked time of thread head H
+  template <size_t H, typename Wait> void timed(Wait &&wait) {
+    const auto start = std::chrono::steady_clock::now();
+    std::forward<Wait>(wait)();
+    const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::atomic<int64_t> &blocked = _counters.at(H).blocked_ns;
+    blocked.store(blocked.load(std::memory_order_relaxed) + waited.count(),
+                  std::memory_order_relaxed);
+  }
+
+  // Pushes into stage K's ring: an element, or std::nullopt to end the
+  // stream
+  template <size_t K, size_t H, typename U> void send(U &&message) {
+    auto &next = ring<K>();
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    if (!next.try_push(std::forward<U>(message))) {
+      timed<H>([&] { next.push_wait(std::forward<U>(message)); });
+    }
+  }
+
+  // Runs stage K and the fused stages after it on thread head H
+  template <size_t K, size_t H> void run(input_t<K> &&value) {
+    auto &function = std::get<K>(_stages).function;
+    if constexpr (K + 1 == stage_count) {
+      function(std::move(value));
+      detail::bump_counter(_counters.at(K).processed);
+    } else {
+      auto result = function(std::move(value));
+      detail::bump_counter(_counters.at(K).processed);
+      if constexpr (is_fused<K + 1>) {
+        run<K + 1, H>(std::move(result));
+      } else {
+        send<K + 1, H>(message_t<K + 1>(std::move(result)));
+      }
+    }
+  }
+
+  template <size_t H> void worker() {
+    bool failed = false;
+    bool done = false;
+    const auto handle = [&](message_t<H> &&message) {
+      if (!message.has_value()) {
+        done = true;
+        return;
+      }
+      if (failed) {
+        return;
+      }
+      try {
+        run<H, H>(std::move(*message));
+      } catch (...) {
+        _errors.at(H) = std::current_exception();
+        failed = true;
+      }
+    };
+
+    auto &input = ring<H>();
+    const size_t batch = std::get<H>(_stages).batch;
+    while (!done) {
+      if (input.consume_up_to(batch, handle) == 0) {
+        std::optional<message_t<H>> message;
+        timed<H>([&] { message.emplace(input.pop_wait()); });
+        handle(std::move(*message));
+      }
+    }
+    if constexpr (next_threaded<H>() < stage_count) {
+      send<next_threaded<H>(), H>(std::nullopt);
+    }
+  }
+
+  template <size_t... K> void create_rings(std::index_sequence<K...> /*all*/) {
+    ((
+         [&] {
+           if constexpr (!is_fused<K>) {
+             std::get<K>(_rings) = std::make_unique<typename ring_for<
+                 K>::type::element_type>();
+           }
+         }()),
+     ...);
+  }
+
+  template <size_t... K> void launch(std::index_sequence<K...> /*all*/) {
+    ((
+         [&] {
+           if constexpr (!is_fused<K>) {
+             _threads.at(K) = std::thread([this] { worker<K>(); });
+             if (const auto &cpu = std::get<K>(_stages).cpu) {
+               detail::pin_thread(_threads.at(K), *cpu);
+             }
+           }
+         }()),
+     ...);
+  }
+
+  void join() noexcept {
+    for (std::thread &thread : _threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+public:
+  explicit Pipeline(Stages... stages) : _stages(std::move(stages)...) {
+    create_rings(std::make_index_sequence<stage_count>{});
+  }
+
+  // Closes the pipeline if it is still running. Stage exceptions are lost
+  // here; call close() to see them
+  ~Pipeline() {
+    if (_started && !_closed) {
+      _closed = true;
+      ring<0>().push_wait(std::nullopt);
+      join();
+    }
+  }
+
+  // Stage threads hold pointers into the pipeline
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+  Pipeline(Pipeline &&) = delete;
+  Pipeline &operator=(Pipeline &&) = delete;
+
+  [[nodiscard]] static constexpr size_t stages() noexcept {
+    return stage_count;
+  }
+
+  // Starts the stage threads and applies their core affinity. Throws
+  // std::system_error if a thread cannot be pinned; the threads already
+  // started are shut down first
+  void start() {
+    if (_started) {
+      throw std::logic_error("Pipeline already started");
+    }
+    _started = true;
+    try {
+      launch(std::make_index_sequence<stage_count>{});
+    } catch (...) {
+      _closed = true;
+      ring<0>().push_wait(std::nullopt);
+      join();
+      throw;
+    }
+  }
+
+  // Producer operations. Only one thread may call these
+
+  template <typename U>
+    requires std::convertible_to<U, In>
+  bool try_push(U &&item) {
+    return ring<0>().try_push(message_t<0>(std::forward<U>(item)));
+  }
+
+  template <typename U>
+    requires std::convertible_to<U, In>
+  void push(U &&item) {
+    ring<0>().push_wait(message_t<0>(std::forward<U>(item)));
+  }
+
+  // Ends the stream and waits until every stage has processed everything
+  // pushed before. Rethrows the first exception a stage function threw
+  void close() {
+    if (!_started || _closed) {
+      return;
+    }
+    _closed = true;
+    ring<0>().push_wait(std::nullopt);
+    join();
+    for (const std::exception_ptr &error : _errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  // Counters of stage k. Safe to call from any thread while the pipeline
+  // runs; a fused stage reports no blocked time of its own, it is included
+  // in the stage that runs it
+  [[nodiscard]] PipelineStageStats stage_stats(size_t k) const {
+    const detail::StageCounters &counters = _counters.at(k);
+    return PipelineStageStats{
+        .processed = counters.processed.load(std::memory_order_relaxed),
+        .blocked = std::chrono::nanoseconds(
+            counters.blocked_ns.load(std::memory_order_relaxed)),
+    };
+  }
+};
+
+// Pipeline fed with In, e.g.
+//   auto pipeline = make_pipeline<Packet, 1024>(
+//       stage(decode).on_core(2), fused(normalize),
+//       stage(publish).wait<AtomicWait<>>());
+template <typename In, size_t Capacity, typename... Stages>
+Pipeline<In, Capacity, Stages...> make_pipeline(Stages... stages) {
+  return Pipeline<In, Capacity, Stages...>(std::move(stages)...);
+}
+
+} // namespace bring
@@ -0,0 +1,43 @@
+#pragma once
+#include <concepts>
+#include <type_traits>
+
+namespace bring {
+
+// Policies are passed to ring templates as an unordered list of types, e.g.
+// RingBuffer<T, 1024, AtomicWait<>>. Each policy names its kind through a
+// nested `policy_kind` alias so the ring can pick it out of the list and fall
+// back to a default when a kind is not given.
+namespace policy_kind {
+struct wait {};
+struct stats {};
+struct storage {};
+struct publish {};
+struct padding {};
+struct latency {};
+struct priority {};
+} // namespace policy_kind
+
+template <typename P>
+concept Policy = requires { typename P::policy_kind; };
+
+namespace detail {
+
+// First policy in Policies... whose kind is Kind, or Default if there is none
+template <typename Kind, typename Default, typename... Policies>
+struct select_policy {
+  using type = Default;
+};
+
+template <typename Kind, typename Default, typename P, typename... Rest>
+struct select_policy<Kind, Default, P, Rest...>
+    : std::conditional_t<std::same_as<typename P::policy_kind, Kind>,
+                         std::type_identity<P>,
+                         select_policy<Kind, Default, Rest...>> {};
+
+template <typename Kind, typename Default, typename... Policies>
+using select_policy_t =
+    typename select_policy<Kind, Default, Policies...>::type;
+
+} // namespace detail
+} // namespace bring
@@ -0,0 +1,244 @@
+#pragma once
+#include "padding.hpp"
+#include "ring_buffer.hpp"
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace bring {
+
+// SPSC channel for messages that own heap buffers. Instead of allocating a
+// payload per message on the producer and freeing it on the consumer, the
+// channel owns an arena of Capacity buffers, constructed once, and passes
+// their indices around: a forward ring carries filled buffers to the
+// consumer, and a return ring brings them back once the consumer is done.
+// Neither side allocates in steady state, and a buffer keeps whatever
+// capacity it grew to.
+//
+//   PoolChannel<std::vector<std::byte>, 256> channel(
+//       [](std::vector<std::byte> &buffer) { buffer.reserve(4096); });
+//
+//   auto lease = channel.acquire_wait();         // producer
+//   lease->assign(payload.begin(), payload.end());
+//   channel.send(std::move(lease));
+//
+//   auto message = channel.receive_wait();       // consumer
+//   process(*message);                           // back to the pool when
+//                                                // message is destroyed
+//
+// The producer keeps free buffers on a stack and takes the most recently
+// freed one first, so a buffer it reuses is likely still in its cache. It
+// only reads the return ring once the stack is empty, and then takes
+// everything returned so far in one batch.
+//
+// Buffers are handed over as they are: the producer sees what the consumer
+// left behind and should reset a buffer before filling it, in a way that
+// keeps its allocation (std::vector::clear, not shrink_to_fit). Lease must be
+// destroyed on the producer thread and Message on the consumer thread, both
+// before the channel. Each buffer sits on its own cache line, so the two
+// threads working on neighbouring buffers do not share lines.
+//
+// Policies... are passed on to both index rings. DeferredPublish is not
+// supported: a Message returns its buffer with a single push that would
+// otherwise sit unpublished
+template <RingElement T, size_t Capacity, Policy... Policies>
+class PoolChannel {
+  using index_type = uint32_t;
+  using index_ring = RingBuffer<index_type, Capacity, Policies...>;
+
+  static_assert(std::default_initializable<T>,
+                "PoolChannel buffers must be default constructible");
+  static_assert(Capacity <= std::numeric_limits<index_type>::max(),
+                "PoolChannel indices are 32-bit");
+  static_assert(!index_ring::publish_policy::deferred,
+                "PoolChannel needs ImmediatePublish");
+
+  struct alignas(destructive_interference_size) Cell {
+    T value;
+  };
+
+  // Read-only after construction
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  std::unique_ptr<Cell[]> _arena;
+
+  // Producer only
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+  std::unique_ptr<index_type[]> _free;
+  size_t _free_count{0};
+
+  index_ring _forward;
+  index_ring _returns;
+
+  T &buffer(index_type index) noexcept { return _arena[index].value; }
+
+  // Every buffer is either on the stack or held by exactly one live handle,
+  // which send() keeps true by only taking this channel's live leases
+  void release_free(index_type index) noexcept {
+    assert(_free_count < Capacity);
+    _free[_free_count++] = index;
+  }
+
+  // Moves everything the consumer returned so far onto the free stack
+  void collect_returns() {
+    _returns.consume_all([this](index_type index) { release_free(index); });
+  }
+
+  template <bool Producer> class Handle {
+    friend class PoolChannel;
+
+    PoolChannel *_channel{nullptr};
+    index_type _index{0};
+
+    Handle(PoolChannel &channel, index_type index) noexcept
+        : _channel(&channel), _index(index) {}
+
+    void reset() noexcept {
+      if (_channel == nullptr) {
+        return;
+      }
+      if constexpr (Producer) {
+        _channel->release_free(_index);
+      } else {
+        // Cannot fail: Capacity buffers and Capacity slots
+        [[maybe_unused]] const bool pushed =
+            _channel->_returns.try_push(_index);
+      }
+      _channel = nullptr;
+    }
+
+  public:
+    Handle(const Handle &) = delete;
+    Handle &operator=(const Handle &) = delete;
+
+    Handle(Handle &&other) noexcept
+        : _channel(std::exchange(other._channel, nullptr)),
+          _index(other._index) {}
+
+    Handle &operator=(Handle &&other) noexcept {
+      if (this != &other) {
+        reset();
+        _channel = std::exchange(other._channel, nullptr);
+        _index = other._index;
+      }
+      return *this;
+    }
+
+    ~Handle() { reset(); }
+
+    [[nodiscard]] T &operator*() const noexcept {
+      return _channel->buffer(_index);
+    }
+    [[nodiscard]] T *operator->() const noexcept {
+      return &_channel->buffer(_index);
+    }
+  };
+
+public:
+  // A free buffer held by the producer. Destroying it without sending puts
+  // the buffer back on the free stack
+  using Lease = Handle<true>;
+  // A buffer received by the consumer. Destroying it returns the buffer to
+  // the producer
+  using Message = Handle<false>;
+
+  PoolChannel() : PoolChannel([](T & /*buffer*/) {}) {}
+
+  // Calls init(T&) on every buffer, e.g. to reserve capacity up front
+  template <std::invocable<T &> Init>
+  explicit PoolChannel(Init init)
+      // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+      : _arena(std::make_unique<Cell[]>(Capacity)),
+        // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+        _free(std::make_unique<index_type[]>(Capacity)) {
+    // Lowest index on top, so buffers are first handed out in arena order
+    for (size_t i = Capacity; i > 0; --i) {
+      const auto index = static_cast<index_type>(i - 1);
+      init(buffer(index));
+      release_free(index);
+    }
+  }
+
+  ~PoolChannel() = default;
+
+  // Handles point into the channel
+  PoolChannel(const PoolChannel &) = delete;
+  PoolChannel &operator=(const PoolChannel &) = delete;
+  PoolChannel(PoolChannel &&) = delete;
+  PoolChannel &operator=(PoolChannel &&) = delete;
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+  // Producer operations. Only one thread may call these
+
+  // A free buffer, or nullopt if all Capacity buffers are in flight
+  [[nodiscard]] std::optional<Lease> try_acquire() {
+    if (_free_count == 0) {
+      collect_returns();
+      if (_free_count == 0) {
+        return std::nullopt;
+      }
+    }
+    return Lease(*this, _free[--_free_count]);
+  }
+
+  // Waits on the return ring with the channel's wait strategy until the
+  // consumer gives a buffer back
+  [[nodiscard]] Lease acquire_wait() {
+    if (std::optional<Lease> lease = try_acquire()) {
+      return std::move(*lease);
+    }
+    return Lease(*this, _returns.pop_wait());
+  }
+
+  // Buffers the producer can acquire without waiting. The consumer may be
+  // returning more meanwhile
+  [[nodiscard]] size_t available() const noexcept {
+    return _free_count + _returns.size();
+  }
+
+  // Hands the leased buffer to the consumer. Never blocks: there is a
+  // forward slot for every buffer. Throws std::invalid_argument for a lease
+  // that is empty (moved from or already sent) or from another channel
+  void send(Lease &&lease) {
+    if (lease._channel != this) {
+      throw std::invalid_argument(
+          "PoolChannel: send() needs a live lease from this channel");
+    }
+    const index_type index = lease._index;
+    lease._channel = nullptr;
+    [[maybe_unused]] const bool pushed = _forward.try_push(index);
+  }
+
+  // Consumer operations. Only one thread may call these
+
+  [[nodiscard]] std::optional<Message> try_receive() {
+    const std::optional<index_type> index = _forward.try_pop();
+    if (!index.has_value()) {
+      return std::nullopt;
+    }
+    return Message(*this, *index);
+  }
+
+  [[nodiscard]] Message receive_wait() {
+    return Message(*this, _forward.pop_wait());
+  }
+
+  template <typename Rep, typename Period>
+  [[nodiscard]] std::optional<Message>
+  receive_wait_for(const std::chrono::duration<Rep, Period> &timeout) {
+    const std::optional<index_type> index = _forward.pop_wait_for(timeout);
+    if (!index.has_value()) {
+      return std::nullopt;
+    }
+    return Message(*this, *index);
+  }
+};
+
+} // namespace bring
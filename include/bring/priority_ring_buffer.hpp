@@ -0,0 +1,246 @@
+#pragma once
+#include "policy.hpp"
+#include "ring_buffer.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace bring {
+
+// Lane capacities of a PriorityRingBuffer, highest priority first
+template <size_t... Capacities> struct Lanes {};
+
+// Priority policies pick the lane each consumer call takes from, given the
+// mask of lanes that hold elements (bit i for lane i, never 0):
+//   next(ready, max) - the lane and how many elements to take from it, at
+//                      most `max`
+//   taken(n)         - n elements were taken from that lane
+// Both run on the consumer thread only.
+
+// Default. Always the highest-priority lane that holds elements: a lower
+// lane is only served while every higher one is empty
+struct StrictPriority {
+  using policy_kind = policy_kind::priority;
+
+  [[nodiscard]] static std::pair<size_t, size_t> next(uint64_t ready,
+                                                      size_t max) noexcept {
+    return {static_cast<size_t>(std::countr_zero(ready)), max};
+  }
+  static void taken(size_t /*count*/) noexcept {}
+};
+
+// Weighted round robin: lane i gets up to Weights[i] elements per turn,
+// then the turn passes to the next lane that holds elements. Under load
+// each lane gets a share proportional to its weight, and no lane starves.
+// An empty lane gives up the rest of its turn
+template <size_t... Weights> class WeightedPriority {
+  static_assert(((Weights > 0) && ...),
+                "WeightedPriority weights must be at least 1");
+
+  static constexpr std::array<size_t, sizeof...(Weights)> weights{Weights...};
+
+public:
+  using policy_kind = policy_kind::priority;
+
+  static constexpr size_t lanes{sizeof...(Weights)};
+
+private:
+  // Starts on the last lane without credit, so the first turn is lane 0's
+  size_t _lane{lanes - 1};
+  size_t _credit{0};
+
+public:
+
+  [[nodiscard]] std::pair<size_t, size_t> next(uint64_t ready,
+                                               size_t max) noexcept {
+    if (_credit == 0 || (ready & (uint64_t{1} << _lane)) == 0) {
+      // Next ready lane after the current one, wrapping around
+      const uint64_t after =
+          _lane + 1 < lanes ? ready >> (_lane + 1) << (_lane + 1) : 0;
+      _lane =
+          static_cast<size_t>(std::countr_zero(after != 0 ? after : ready));
+      _credit = weights.at(_lane);
+    }
+    return {_lane, std::min(max, _credit)};
+  }
+
+  void taken(size_t count) noexcept { _credit -= count; }
+};
+
+template <RingElement T, typename LaneList, Policy... Policies>
+class PriorityRingBuffer;
+
+// SPSC channel of sizeof...(Capacities) FIFO lanes, each a RingBuffer with
+// its own capacity. The producer chooses the lane of every element, and the
+// consumer takes from the lane the priority policy picks, so urgent
+// elements (cancels) can overtake a deep backlog of ordinary ones (new
+// orders). Elements of one lane stay in order; across lanes there is no
+// order.
+//
+//   PriorityRingBuffer<Msg, Lanes<64, 4096>> gateway;   // lane 0 first
+//   gateway.try_push(0, cancel);
+//   gateway.try_push(1, order);
+//   gateway.consume_n(32, handle);  // up to 32 from the chosen lane
+//
+// The consumer finds the lanes that hold elements by building a bitmask
+// from each lane's indices. It loads each lane's head on every call, but
+// the producer writes neither a shared mask nor anything else beyond the
+// lanes themselves, so a push costs the same as a RingBuffer push. A
+// producer-maintained mask would need a fence per push to avoid losing a
+// lane's bit to a concurrent clear, as RingSet pays. While a lane's head has
+// not changed its line stays in the consumer's cache, so the loads are
+// cheap for up to 64 lanes.
+//
+// Policies... hold the priority policy (StrictPriority by default,
+// WeightedPriority<W...>) and are passed on to every lane's RingBuffer
+template <RingElement T, size_t... Capacities, Policy... Policies>
+class PriorityRingBuffer<T, Lanes<Capacities...>, Policies...> {
+public:
+  using priority_policy =
+      detail::select_policy_t<policy_kind::priority, StrictPriority,
+                              Policies...>;
+
+  static constexpr size_t lanes{sizeof...(Capacities)};
+
+private:
+  static_assert(lanes > 0 && lanes <= 64,
+                "PriorityRingBuffer needs between 1 and 64 lanes");
+  [[nodiscard]] static constexpr bool policy_fits() noexcept {
+    if constexpr (requires { priority_policy::lanes; }) {
+      return priority_policy::lanes == lanes;
+    } else {
+      return true;
+    }
+  }
+  static_assert(policy_fits(), "WeightedPriority needs one weight per lane");
+
+  using Indices = std::make_index_sequence<lanes>;
+
+  std::tuple<RingBuffer<T, Capacities, Policies...>...> _lanes;
+  priority_policy _priority;
+
+  template <size_t... I>
+  [[nodiscard]] uint64_t ready_mask(std::index_sequence<I...> /*lanes*/)
+      const noexcept {
+    return ((std::get<I>(_lanes).is_empty() ? uint64_t{0} : uint64_t{1} << I) |
+            ...);
+  }
+
+  // Calls fn on lane `lane`'s ring, which must be below `lanes`
+  template <size_t I = 0, typename Fn>
+  decltype(auto) visit(size_t lane, Fn &&fn) {
+    if constexpr (I + 1 == lanes) {
+      return fn(std::get<I>(_lanes));
+    } else {
+      if (lane == I) {
+        return fn(std::get<I>(_lanes));
+      }
+      return visit<I + 1>(lane, std::forward<Fn>(fn));
+    }
+  }
+
+public:
+  // Producer operations. Only one thread may call these
+
+  // Pushes into lane `lane`; false if that lane is full. Lanes beyond the
+  // last are rejected as full
+  template <typename U>
+    requires std::constructible_from<T, U &&>
+  bool try_push(size_t lane, U &&item) {
+    if (lane >= lanes) {
+      return false;
+    }
+    return visit(lane, [&item](auto &ring) {
+      return ring.try_push(std::forward<U>(item));
+    });
+  }
+
+  template <typename... Args>
+    requires std::constructible_from<T, Args...>
+  bool emplace(size_t lane, Args &&...args) {
+    if (lane >= lanes) {
+      return false;
+    }
+    return visit(lane, [&args...](auto &ring) {
+      return ring.emplace(std::forward<Args>(args)...);
+    });
+  }
+
+  // Consumer operations. Only one thread may call these
+
+  // Lanes that hold elements, bit i for lane i
+  [[nodiscard]] uint64_t ready_lanes() const noexcept {
+    return ready_mask(Indices{});
+  }
+
+  [[nodiscard]] bool is_empty() const noexcept { return ready_lanes() == 0; }
+
+  // Passes up to `max` elements, oldest first, from the lane the priority
+  // policy picks to processor(T&&). Returns the number consumed; 0 if every
+  // lane is empty
+  template <typename Func> size_t consume_n(size_t max, Func &&processor) {
+    const uint64_t ready = ready_lanes();
+    if (ready == 0 || max == 0) {
+      return 0;
+    }
+    const auto [lane, budget] = _priority.next(ready, max);
+    const size_t consumed =
+        visit(lane, [&, limit = budget](auto &ring) -> size_t {
+          if (limit == 1) {
+            return ring.try_consume(processor) ? 1 : 0;
+          }
+          return ring.consume_up_to(limit, processor);
+        });
+    _priority.taken(consumed);
+    return consumed;
+  }
+
+  template <typename Func> bool try_consume(Func &&processor) {
+    return consume_n(1, std::forward<Func>(processor)) == 1;
+  }
+
+  [[nodiscard]] std::optional<T> try_pop() {
+    const uint64_t ready = ready_lanes();
+    if (ready == 0) {
+      return std::nullopt;
+    }
+    std::optional<T> result =
+        visit(_priority.next(ready, 1).first,
+              [](auto &ring) { return ring.try_pop(); });
+    if (result.has_value()) {
+      _priority.taken(1);
+    }
+    return result;
+  }
+
+  // Observer operations, safe from any thread like their RingBuffer
+  // counterparts
+
+  // Elements in all lanes
+  [[nodiscard]] size_t size() const noexcept {
+    return std::apply(
+        [](const auto &...rings) { return (rings.size() + ...); }, _lanes);
+  }
+
+  [[nodiscard]] static constexpr std::array<size_t, lanes>
+  capacities() noexcept {
+    return {Capacities...};
+  }
+
+  // Lane I, e.g. for its stats() or latency(). Push and pop through the
+  // channel, not the lane
+  template <size_t I> [[nodiscard]] auto &lane() noexcept {
+    return std::get<I>(_lanes);
+  }
+  template <size_t I> [[nodiscard]] const auto &lane() const noexcept {
+    return std::get<I>(_lanes);
+  }
+};
+
+} // namespace bring
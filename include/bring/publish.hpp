@@ -0,0 +1,33 @@
+#pragma once
+#include "policy.hpp"
+#include <cstddef>
+
+namespace bring {
+
+// Publish policies decide when a side makes its progress visible to the
+// other one. Each policy provides:
+//   deferred  - false: every operation stores its index with release
+//               true: operations advance a private index that is stored on
+//                     publish()/release_consumed(), every `interval`
+//                     elements, or when the side finds the ring full/empty
+//   interval  - with deferred, elements per automatic publication; 0 means
+//               only explicitly or when the side would otherwise stall
+
+// Default. One release store per operation
+struct ImmediatePublish {
+  using policy_kind = policy_kind::publish;
+  static constexpr bool deferred{false};
+  static constexpr size_t interval{1};
+};
+
+// Coalesces index stores on both sides. A producer pushing in a loop stops
+// invalidating the consumer's copy of head's cache line on every push, and
+// the consumer does the same for tail. Elements become visible later, so
+// this trades latency for throughput
+template <size_t Interval = 0> struct DeferredPublish {
+  using policy_kind = policy_kind::publish;
+  static constexpr bool deferred{true};
+  static constexpr size_t interval{Interval};
+};
+
+} // namespace bring
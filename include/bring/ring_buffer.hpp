@@ -1,179 +1,1053 @@
 #pragma once
-#include <array>
+#include "common.hpp"
+#include "coroutine_wait.hpp"
+#include "latency.hpp"
+#include "padding.hpp"
+#include "policy.hpp"
+#include "publish.hpp"
+#include "stats.hpp"
+#include "storage.hpp"
+#include "wait_strategy.hpp"
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <concepts>
+#include <coroutine>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace bring {
 
-template <typename T>
-concept RingElement = std::move_constructible<T> && std::destructible<T>;
-template <RingElement T, size_t Capacity> class RingBuffer {
-  static_assert((Capacity & (Capacity - 1)) == 0,
-                "Capacity must be power of two");
-  static_assert(Capacity > 1, "Capacity must be greater than 1");
+// SPSC ring buffer core shared by the static and runtime-sized variants. Use
+// it through the RingBuffer and DynamicRingBuffer aliases below.
+//
+// Policies... is an unordered list of optional policies (see policy.hpp):
+//   wait strategy - BusySpinWait (default), SpinYieldWait<>, AtomicWait<>,
+//                   CoroutineWait<> (enables async_push/async_pop),
+//                   EventFdWait<> (eventfd_wait.hpp, enables native_handle),
+//                   RingSetNotify (ring_set.hpp, set by RingSet)
+//   stats         - NoStats (default), RingStats
+//   storage       - HeapStorage (default), ResourceStorage, InlineStorage
+//   publish       - ImmediatePublish (default), DeferredPublish<Interval>
+//   padding       - InterferencePadding (default), Padding128,
+//                   CacheLinePadding<Bytes>
+//   latency       - NoLatencySampling (default), LatencySampling<Every>
+template <RingElement T, typename CapacityPolicy, Policy... Policies>
+class BasicRingBuffer {
+public:
+  using padding_policy =
+      detail::select_policy_t<policy_kind::padding, InterferencePadding,
+                              Policies...>;
+  // The stateful wait, stats and latency policies are rebound to the
+  // padding policy's line size, e.g. AtomicWait<> in a Padding128 ring is
+  // AtomicWait<64, 128>
+  using wait_strategy = detail::padded_policy_t<
+      detail::select_policy_t<policy_kind::wait, BusySpinWait, Policies...>,
+      padding_policy::line_size>;
+  using stats_policy = detail::padded_policy_t<
+      detail::select_policy_t<policy_kind::stats, NoStats, Policies...>,
+      padding_policy::line_size>;
+  using storage_policy =
+      detail::select_policy_t<policy_kind::storage, HeapStorage, Policies...>;
+  using publish_policy =
+      detail::select_policy_t<policy_kind::publish, ImmediatePublish,
+                              Policies...>;
+  using latency_policy = detail::padded_policy_t<
+      detail::select_policy_t<policy_kind::latency, NoLatencySampling,
+                              Policies...>,
+      padding_policy::line_size>;
 
 private:
-  struct Slot {
-    alignas(T) std::array<std::byte, sizeof(T)> _data;
-  };
+  using Slot = detail::Slot<T>;
+  using Storage = typename storage_policy::template storage<Slot, CapacityPolicy>;
+  static constexpr bool inline_storage{detail::InlineSlots<Storage>};
+  // Trivially copyable elements are moved around as raw bytes: bulk
+  // transfers become one memcpy per contiguous segment and nothing needs to
+  // be destroyed when draining
+  static constexpr bool trivial{std::is_trivially_copyable_v<T>};
+  static constexpr bool deferred{publish_policy::deferred};
+  static constexpr bool coroutine_wait{
+      requires(wait_strategy &wait, detail::CoroutineWaiter &waiter,
+               const std::atomic<size_t> &index) {
+        wait.suspend_for_data(waiter, index, size_t{});
+        wait.suspend_for_space(waiter, index, size_t{});
+      }};
 
-  // Prevent false sharing. head and tail should be on different cache lines. 64
-  // is a safe option for all modern architectures
-  static constexpr size_t align_size{64};
+  // Prevent false sharing: each group of fields written by one side, and the
+  // read-only group, starts on its own padding_policy::line_size line
+  static constexpr size_t align_size{padding_policy::line_size};
+  // head and tail are free-running counters, only masked when indexing
+  // _storage. head - tail is the number of elements, so all Capacity slots
+  // are usable and the unsigned subtraction stays correct across wraparound
   alignas(align_size) std::atomic<size_t> _head{0};
+  // Producer-private copy of _tail. Only refreshed from the shared atomic when
+  // it makes the buffer look full, so most pushes never touch _tail's line
+  alignas(align_size) size_t _cached_tail{0};
+  // With DeferredPublish: the producer's head including pushes not yet
+  // stored to _head. Shares the producer-private line, unused otherwise
+  size_t _local_head{0};
   alignas(align_size) std::atomic<size_t> _tail{0};
+  // Consumer-private copy of _head, refreshed only when the buffer looks empty
+  alignas(align_size) size_t _cached_head{0};
+  // With DeferredPublish: the consumer's tail including pops not yet stored
+  // to _tail
+  size_t _local_tail{0};
+
+  // Read-only after construction, shared by both threads
+  alignas(align_size) CapacityPolicy _capacity;
+  Storage _storage;
+
+  // Stateful policies start a new line, so their state is neither next to
+  // the storage handle every operation reads nor next to another policy's
+  template <typename Policy>
+  static constexpr size_t policy_align{
+      std::is_empty_v<Policy> ? alignof(Policy)
+                              : std::max(align_size, alignof(Policy))};
 
-  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
-  std::unique_ptr<Slot[]> _storage;
+  // Empty for the polling strategies; AtomicWait keeps its parked flags here,
+  // each on its own cache line
+  alignas(policy_align<wait_strategy>)
+      [[no_unique_address]] wait_strategy _wait;
+  // Empty for NoStats; RingStats keeps producer and consumer counters on
+  // separate cache lines
+  alignas(policy_align<stats_policy>)
+      [[no_unique_address]] stats_policy _stats;
+  // Empty for NoLatencySampling; LatencySampling keeps its stamps and its
+  // histogram on their own lines
+  alignas(policy_align<latency_policy>)
+      [[no_unique_address]] latency_policy _latency;
 
   T *get_ptr(size_t idx) noexcept {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    return reinterpret_cast<T *>(&_storage[idx]._data);
+    return _storage[idx & mask()].get();
   }
 
-public:
-  // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
-  RingBuffer() : _storage(std::make_unique<Slot[]>(Capacity)) {};
+  // Elements between the published tail and head. tail is loaded first,
+  // with acquire, so the head load sees at least the head the consumer had
+  // seen when it stored that tail: the difference cannot underflow. It can
+  // exceed the capacity if the consumer freed slots and the producer
+  // refilled them between the two loads, hence the clamp
+  [[nodiscard]] size_t occupancy() const noexcept {
+    const size_t current_tail = _tail.load(std::memory_order_acquire);
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    return std::min(current_head - current_tail, capacity());
+  }
+
+  // Producer side: true if there is a free slot at current_head. The shared
+  // tail is only loaded when the cached copy says the buffer is full
+  [[nodiscard]] bool producer_has_room(size_t current_head) noexcept {
+    if (current_head - _cached_tail == capacity()) {
+      _cached_tail = _tail.load(std::memory_order_acquire);
+      _stats.on_producer_sync(current_head - _cached_tail);
+      if (current_head - _cached_tail == capacity()) {
+        _stats.on_push_full();
+        flush_head();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Consumer side: true if current_tail has a published element behind it.
+  // The shared head is only loaded when the cached copy says it is empty
+  [[nodiscard]] bool consumer_has_data(size_t current_tail) noexcept {
+    if (current_tail == _cached_head) {
+      _cached_head = _head.load(std::memory_order_acquire);
+      _stats.on_consumer_sync(_cached_head - current_tail);
+      if (current_tail == _cached_head) {
+        _stats.on_pop_empty();
+        flush_tail();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Producer side: number of free slots after current_head. The shared tail
+  // is only reloaded when the cached copy cannot satisfy `wanted`
+  [[nodiscard]] size_t producer_free(size_t current_head,
+                                     size_t wanted) noexcept {
+    size_t free_slots = capacity() - (current_head - _cached_tail);
+    if (free_slots < wanted) {
+      _cached_tail = _tail.load(std::memory_order_acquire);
+      free_slots = capacity() - (current_head - _cached_tail);
+      _stats.on_producer_sync(current_head - _cached_tail);
+      if (free_slots == 0) {
+        _stats.on_push_full();
+        flush_head();
+      }
+    }
+    return free_slots;
+  }
+
+  // Consumer side: number of published elements from current_tail. The shared
+  // head is only reloaded when the cached copy cannot satisfy `wanted`
+  [[nodiscard]] size_t consumer_available(size_t current_tail,
+                                          size_t wanted) noexcept {
+    size_t available = _cached_head - current_tail;
+    if (available < wanted) {
+      _cached_head = _head.load(std::memory_order_acquire);
+      available = _cached_head - current_tail;
+      _stats.on_consumer_sync(available);
+      if (available == 0) {
+        _stats.on_pop_empty();
+        flush_tail();
+      }
+    }
+    return available;
+  }
 
-  ~RingBuffer() {
-    while (try_consume([]([[maybe_unused]] T && /* discard */) {})) {
+  // Number of slots from idx to the end of _storage
+  [[nodiscard]] size_t contiguous_from(size_t idx) const noexcept {
+    return capacity() - (idx & mask());
+  }
+
+  // Calls fn(first_idx, count) for the one or two contiguous runs of slots
+  // that make up `n` slots starting at `start`, in ring order
+  template <typename Fn>
+  void for_each_segment(size_t start, size_t n, Fn &&fn) const {
+    const size_t first = std::min(n, contiguous_from(start));
+    if (first > 0) {
+      fn(start, first);
+    }
+    if (n > first) {
+      fn(start + first, n - first);
+    }
+  }
+
+  [[nodiscard]] size_t mask() const noexcept { return _capacity.mask(); }
+
+  // Each side's own index: the shared atomic, or with DeferredPublish the
+  // private copy that runs ahead of it
+  [[nodiscard]] size_t producer_head() const noexcept {
+    if constexpr (deferred) {
+      return _local_head;
+    } else {
+      return _head.load(std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] size_t consumer_tail() const noexcept {
+    if constexpr (deferred) {
+      return _local_tail;
+    } else {
+      return _tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Every index publication goes through these so the wait strategy can wake a
+  // parked peer and the stats policy can count it. For the polling strategies
+  // and NoStats both calls are no-ops. Empty publications are skipped, so a
+  // woken peer always finds at least one element or free slot
+  void store_head(size_t new_head, size_t pushed) noexcept {
+    _head.store(new_head, std::memory_order_release);
+    _wait.notify_data(_head);
+    _stats.on_push(pushed);
+  }
+
+  void store_tail(size_t new_tail, size_t popped) noexcept {
+    _tail.store(new_tail, std::memory_order_release);
+    _wait.notify_space(_tail);
+    _stats.on_pop(popped);
+  }
+
+  // Called by every producer operation. With DeferredPublish it only
+  // advances _local_head, and stores it once `interval` pushes are pending
+  void publish_head(size_t current_head, size_t pushed) noexcept {
+    if (pushed == 0) {
+      return;
+    }
+    _latency.on_push(current_head, pushed);
+    if constexpr (deferred) {
+      _local_head = current_head + pushed;
+      if (publish_policy::interval != 0 &&
+          _local_head - _head.load(std::memory_order_relaxed) >=
+              publish_policy::interval) {
+        flush_head();
+      }
+    } else {
+      store_head(current_head + pushed, pushed);
+    }
+  }
+
+  void publish_tail(size_t current_tail, size_t popped) noexcept {
+    if (popped == 0) {
+      return;
+    }
+    _latency.on_pop(current_tail, popped);
+    if constexpr (deferred) {
+      _local_tail = current_tail + popped;
+      if (publish_policy::interval != 0 &&
+          _local_tail - _tail.load(std::memory_order_relaxed) >=
+              publish_policy::interval) {
+        flush_tail();
+      }
+    } else {
+      store_tail(current_tail + popped, popped);
     }
   }
-  RingBuffer(const RingBuffer &) = delete;
-  RingBuffer &operator=(const RingBuffer &) = delete;
 
-  RingBuffer(RingBuffer &&other) noexcept
+  // Store the pending index, if any. Also called whenever a side finds the
+  // ring full or empty, so two sides waiting on each other always see each
+  // other's progress
+  void flush_head() noexcept {
+    if constexpr (deferred) {
+      const size_t published = _head.load(std::memory_order_relaxed);
+      if (_local_head != published) {
+        store_head(_local_head, _local_head - published);
+      }
+    }
+  }
+
+  void flush_tail() noexcept {
+    if constexpr (deferred) {
+      const size_t published = _tail.load(std::memory_order_relaxed);
+      if (_local_tail != published) {
+        store_tail(_local_tail, _local_tail - published);
+      }
+    }
+  }
+
+  // Move-constructs count elements from source into the uninitialized slots
+  // at destination and destroys the sources
+  static void move_elements(T *destination, T *source, size_t count) noexcept
+    requires std::is_nothrow_move_constructible_v<T>
+  {
+    if constexpr (trivial) {
+      std::memcpy(destination, source, count * sizeof(T));
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::construct_at(destination + i, std::move(source[i]));
+        std::destroy_at(source + i);
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      }
+    }
+  }
+
+  // Destroys every element, including pushes DeferredPublish has not
+  // published yet. Only for the destructor and move assignment, when no
+  // other thread uses the ring. The slots are destroyed in place, so the
+  // stats, latency and wait hooks of a pop never see them. A no-op for
+  // trivially copyable elements, whose indices are about to be discarded or
+  // overwritten anyway
+  void destroy_all() noexcept {
+    if constexpr (!trivial) {
+      const size_t current_tail = consumer_tail();
+      for_each_segment(current_tail, producer_head() - current_tail,
+                       [this](size_t idx, size_t count) {
+                         std::destroy_n(get_ptr(idx), count);
+                       });
+    }
+  }
+
+  // Wait strategies that own a resource (EventFdWait's descriptor) move with
+  // the ring; the others only hold per-ring flags and start fresh
+  static wait_strategy take_wait(wait_strategy &other) noexcept {
+    if constexpr (std::is_nothrow_move_constructible_v<wait_strategy>) {
+      return std::move(other);
+    } else {
+      static_cast<void>(other);
+      return wait_strategy{};
+    }
+  }
+
+  // Move step for inline storage, after the indices were copied from other:
+  // move-construct other's live elements into the same slots of this ring
+  void take_elements(BasicRingBuffer &other) noexcept {
+    if constexpr (inline_storage) {
+      const size_t current_tail = consumer_tail();
+      const size_t current_head = producer_head();
+      for_each_segment(current_tail, current_head - current_tail,
+                       [&](size_t idx, size_t count) {
+                         move_elements(get_ptr(idx), other.get_ptr(idx),
+                                       count);
+                       });
+    } else {
+      static_cast<void>(other);
+    }
+  }
+
+public:
+  BasicRingBuffer()
+    requires std::default_initializable<CapacityPolicy> &&
+                 std::constructible_from<Storage, size_t>
+      : _storage(_capacity.capacity()) {}
+
+  explicit BasicRingBuffer(size_t capacity)
+    requires std::constructible_from<CapacityPolicy, size_t> &&
+                 std::constructible_from<Storage, size_t>
+      : _capacity(capacity), _storage(_capacity.capacity()) {}
+
+  // With ResourceStorage: take the slot array from `resource`, which must
+  // outlive the ring
+  explicit BasicRingBuffer(std::pmr::memory_resource *resource)
+    requires std::default_initializable<CapacityPolicy> &&
+                 std::constructible_from<Storage, size_t,
+                                         std::pmr::memory_resource *>
+      : _storage(_capacity.capacity(), resource) {}
+
+  BasicRingBuffer(size_t capacity, std::pmr::memory_resource *resource)
+    requires std::constructible_from<CapacityPolicy, size_t> &&
+                 std::constructible_from<Storage, size_t,
+                                         std::pmr::memory_resource *>
+      : _capacity(capacity), _storage(_capacity.capacity(), resource) {}
+
+  ~BasicRingBuffer() {
+    static_assert(layout().separated(),
+                  "RingBuffer field groups must not share a cache line");
+    static_assert(alignof(BasicRingBuffer) >= align_size &&
+                  sizeof(BasicRingBuffer) % align_size == 0);
+    destroy_all();
+  }
+  BasicRingBuffer(const BasicRingBuffer &) = delete;
+  BasicRingBuffer &operator=(const BasicRingBuffer &) = delete;
+
+  // Inline storage cannot hand its slots over, so its moves move every live
+  // element instead, which needs a nothrow move constructor
+  BasicRingBuffer(BasicRingBuffer &&other) noexcept
+    requires(!inline_storage || std::is_nothrow_move_constructible_v<T>)
       : _head(other._head.load(std::memory_order_relaxed)),
+        _cached_tail(other._cached_tail), _local_head(other._local_head),
         _tail(other._tail.load(std::memory_order_relaxed)),
-        _storage(std::move(other._storage)) {
+        _cached_head(other._cached_head), _local_tail(other._local_tail),
+        _capacity(other._capacity),
+        _storage(std::move(other._storage)), _wait(take_wait(other._wait)) {
+    take_elements(other);
     other._head.store(0, std::memory_order_relaxed);
     other._tail.store(0, std::memory_order_relaxed);
+    other._cached_tail = 0;
+    other._cached_head = 0;
+    other._local_head = 0;
+    other._local_tail = 0;
   }
 
-  RingBuffer &operator=(RingBuffer &&other) noexcept {
+  BasicRingBuffer &operator=(BasicRingBuffer &&other) noexcept
+    requires(!inline_storage || std::is_nothrow_move_constructible_v<T>)
+  {
     if (this != &other) {
-      // Clean up existing elements
-      while (try_pop()) { /* Destroy all */
-      }
+      destroy_all();
 
       _head.store(other._head.load(std::memory_order_relaxed),
                   std::memory_order_relaxed);
       _tail.store(other._tail.load(std::memory_order_relaxed),
                   std::memory_order_relaxed);
+      _cached_tail = other._cached_tail;
+      _cached_head = other._cached_head;
+      _local_head = other._local_head;
+      _local_tail = other._local_tail;
+      _capacity = other._capacity;
       _storage = std::move(other._storage);
+      take_elements(other);
+      if constexpr (std::is_move_assignable_v<wait_strategy>) {
+        _wait = std::move(other._wait);
+      }
 
       other._head.store(0, std::memory_order_relaxed);
       other._tail.store(0, std::memory_order_relaxed);
+      other._cached_tail = 0;
+      other._cached_head = 0;
+      other._local_head = 0;
+      other._local_tail = 0;
     }
     return *this;
   }
 
-  [[nodiscard]] bool is_full() noexcept {
-    const size_t current_head = _head.load(std::memory_order_acquire);
-    const size_t next_head = (current_head + 1) & (Capacity - 1);
-    // If next_head hits tail, buffer is full
-    return next_head == _tail.load(std::memory_order_acquire);
+  [[nodiscard]] size_t capacity() const noexcept {
+    return _capacity.capacity();
+  }
+
+  // Observer operations. Besides the producer and the consumer, any number
+  // of monitoring threads may call capacity(), size(), approx_size(),
+  // free_space(), is_empty(), is_full(), get_state(), stats(), latency() and
+  // layout(). Each index query is a fixed two loads of the indices with no
+  // retry loop, so the answer is bounded-stale: it held at some moment
+  // during the call. Called from the producer or the consumer they are
+  // exact. With DeferredPublish they only count published progress. Every
+  // other operation belongs to one side
+
+  // Number of elements in the buffer
+  [[nodiscard]] size_t size() const noexcept { return occupancy(); }
+
+  // size() under the name a monitoring thread should use: from a third
+  // thread the count may be stale by the time it is returned
+  [[nodiscard]] size_t approx_size() const noexcept { return occupancy(); }
+
+  [[nodiscard]] size_t free_space() const noexcept {
+    return capacity() - occupancy();
+  }
+
+  [[nodiscard]] bool is_full() const noexcept {
+    return occupancy() == capacity();
+  }
+
+  [[nodiscard]] bool is_empty() const noexcept { return occupancy() == 0; }
+
+  // With DeferredPublish: make every push so far visible to the consumer.
+  // Producer only. A no-op with ImmediatePublish
+  void publish() noexcept { flush_head(); }
+
+  // With DeferredPublish: hand every slot consumed so far back to the
+  // producer. Consumer only. A no-op with ImmediatePublish
+  void release_consumed() noexcept { flush_tail(); }
+
+  // Counters of the RingStats policy. Safe to call from any thread
+  [[nodiscard]] RingStatsSnapshot stats() const noexcept
+    requires requires(const stats_policy &policy) { policy.snapshot(); }
+  {
+    return _stats.snapshot();
+  }
+
+  // Dwell-time histogram of the LatencySampling policy, in read_ticks()
+  // ticks. Safe to call from any thread
+  [[nodiscard]] const LatencyHistogram &latency() const noexcept
+    requires requires(const latency_policy &policy) { policy.histogram(); }
+  {
+    return _latency.histogram();
   }
 
-  [[nodiscard]] bool is_empty() noexcept {
-    const size_t current_head = _head.load(std::memory_order_acquire);
-    // If tail equals head, buffer is empty
-    return current_head == _tail.load(std::memory_order_acquire);
+  // The ring's wait strategy, for strategies that are configured after the
+  // ring is built. RingSet binds each ring's RingSetNotify this way
+  [[nodiscard]] wait_strategy &waiter() noexcept { return _wait; }
+
+  // Where the field groups ended up, e.g. to print from a benchmark. The
+  // destructor static_asserts that no two groups share a line
+  [[nodiscard]] static constexpr RingLayout layout() noexcept {
+    // offsetof on a non-standard-layout class is conditionally supported;
+    // GCC, Clang and MSVC all give the member offset
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+    return RingLayout{
+        .line_size = align_size,
+        .head = offsetof(BasicRingBuffer, _head),
+        .producer_cache = offsetof(BasicRingBuffer, _cached_tail),
+        .tail = offsetof(BasicRingBuffer, _tail),
+        .consumer_cache = offsetof(BasicRingBuffer, _cached_head),
+        .shared = offsetof(BasicRingBuffer, _capacity),
+        .wait = std::is_empty_v<wait_strategy>
+                    ? RingLayout::absent
+                    : offsetof(BasicRingBuffer, _wait),
+        .stats = std::is_empty_v<stats_policy>
+                     ? RingLayout::absent
+                     : offsetof(BasicRingBuffer, _stats),
+        .latency = std::is_empty_v<latency_policy>
+                       ? RingLayout::absent
+                       : offsetof(BasicRingBuffer, _latency),
+        .size = sizeof(BasicRingBuffer),
+    };
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
   }
 
-  // Check both empty and full state from a consistent atomic snapshot
+  // size, empty and full from one pair of index loads, so they always agree
+  // with each other
   struct BufferState {
     bool empty;
     bool full;
+    size_t size;
   };
 
-  [[nodiscard]] BufferState get_state() noexcept {
-    // Read head and tail in a loop until we get a consistent snapshot
-    // This prevents race conditions where values change between reads
-    size_t head1, tail1, head2, tail2;
-    do {
-      head1 = _head.load(std::memory_order_acquire);
-      tail1 = _tail.load(std::memory_order_acquire);
-      head2 = _head.load(std::memory_order_acquire);
-      tail2 = _tail.load(std::memory_order_acquire);
-    } while (head1 != head2 || tail1 != tail2);
-
-    const size_t next_head = (head1 + 1) & (Capacity - 1);
+  [[nodiscard]] BufferState get_state() const noexcept {
+    const size_t count = occupancy();
     return BufferState{
-        .empty = (head1 == tail1),
-        .full = (next_head == tail1)
+        .empty = count == 0,
+        .full = count == capacity(),
+        .size = count,
     };
   }
 
   template <typename U>
     requires std::convertible_to<U, T>
   bool try_push(U &&item) {
-    const size_t current_head = _head.load(std::memory_order_relaxed);
-    const size_t next_head = (current_head + 1) & (Capacity - 1);
-    // If next_head hits tail, buffer is full
-    if (next_head == _tail.load(std::memory_order_acquire)) {
+    const size_t current_head = producer_head();
+    if (!producer_has_room(current_head)) {
       return false;
     }
 
     new (get_ptr(current_head)) T(std::forward<U>(item));
 
-    _head.store(next_head, std::memory_order_release);
+    publish_head(current_head, 1);
     return true;
   }
 
   bool try_pop_ip(T &out) {
-    const size_t current_tail = _tail.load(std::memory_order_relaxed);
-    if (current_tail == _head.load(std::memory_order_acquire)) {
+    const size_t current_tail = consumer_tail();
+    if (!consumer_has_data(current_tail)) {
       return false;
     }
 
     T *element_ptr = get_ptr(current_tail);
     out = std::move(*element_ptr);
     element_ptr->~T();
-    _tail.store((current_tail + 1) & (Capacity - 1), std::memory_order_release);
+    publish_tail(current_tail, 1);
     return true;
   }
 
   [[nodiscard]] std::optional<T> try_pop() {
-    const size_t current_tail = _tail.load(std::memory_order_relaxed);
-    if (current_tail == _head.load(std::memory_order_acquire)) {
+    const size_t current_tail = consumer_tail();
+    if (!consumer_has_data(current_tail)) {
       return std::nullopt;
     }
 
     T *element_ptr = get_ptr(current_tail);
     std::optional<T> result(std::move(*element_ptr));
     element_ptr->~T();
-    _tail.store((current_tail + 1) & (Capacity - 1), std::memory_order_release);
+    publish_tail(current_tail, 1);
     return result;
   }
   template <typename Func> bool try_consume(Func &&processor) {
-    const size_t current_tail = _tail.load(std::memory_order_relaxed);
-    if (current_tail == _head.load(std::memory_order_acquire)) {
+    const size_t current_tail = consumer_tail();
+    if (!consumer_has_data(current_tail)) {
       return false;
     }
 
     T *element_ptr = get_ptr(current_tail);
     std::forward<Func>(processor)(std::move(*element_ptr));
     element_ptr->~T();
-    _tail.store((current_tail + 1) & (Capacity - 1), std::memory_order_release);
+    publish_tail(current_tail, 1);
     return true;
   }
 
   template <typename... Args>
     requires std::constructible_from<T, Args...>
   bool emplace(Args &&...args) {
-    const size_t current_head = _head.load(std::memory_order_relaxed);
-    const size_t next_head = (current_head + 1) & (Capacity - 1);
-    // If next_head hits tail, buffer is full
-    if (next_head == _tail.load(std::memory_order_acquire)) {
+    const size_t current_head = producer_head();
+    if (!producer_has_room(current_head)) {
       return false;
     }
     new (get_ptr(current_head)) T(std::forward<Args>(args)...);
-    _head.store(next_head, std::memory_order_release);
+    publish_head(current_head, 1);
     return true;
   }
+
+  // Bulk operations. Each one checks free space (or available elements) once,
+  // transfers as many elements as fit, and publishes them with a single
+  // release store. They return the number of elements transferred, which may
+  // be less than requested. If an element operation throws, the elements
+  // transferred before it are published and the exception propagates.
+  // Trivially copyable elements are copied with one memcpy per contiguous
+  // segment, from contiguous sized input ranges and into try_pop_n's span.
+
+  template <std::input_iterator It, std::sentinel_for<It> S>
+    requires std::constructible_from<T, std::iter_reference_t<It>>
+  size_t try_push_n(It first, S last) {
+    const size_t current_head = producer_head();
+    size_t wanted = capacity();
+    if constexpr (std::sized_sentinel_for<S, It>) {
+      wanted = static_cast<size_t>(std::ranges::distance(first, last));
+    }
+    const size_t n = std::min(wanted, producer_free(current_head, wanted));
+
+    if constexpr (trivial && std::contiguous_iterator<It> &&
+                  std::sized_sentinel_for<S, It> &&
+                  std::same_as<std::iter_value_t<It>, T>) {
+      const T *source = std::to_address(first);
+      for_each_segment(current_head, n, [&](size_t idx, size_t count) {
+        std::memcpy(get_ptr(idx), source, count * sizeof(T));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        source += count;
+      });
+      publish_head(current_head, n);
+      return n;
+    }
+
+    size_t pushed = 0;
+    try {
+      for_each_segment(current_head, n, [&](size_t idx, size_t count) {
+        for (size_t i = 0; i < count && first != last; ++i, ++first) {
+          new (get_ptr(idx + i)) T(*first);
+          ++pushed;
+        }
+      });
+    } catch (...) {
+      publish_head(current_head, pushed);
+      throw;
+    }
+    publish_head(current_head, pushed);
+    return pushed;
+  }
+
+  size_t try_push_n(std::span<const T> items)
+    requires std::copy_constructible<T>
+  {
+    return try_push_n(items.begin(), items.end());
+  }
+
+  size_t try_pop_n(std::span<T> out) {
+    const size_t current_tail = consumer_tail();
+    const size_t n =
+        std::min(out.size(), consumer_available(current_tail, out.size()));
+
+    if constexpr (trivial) {
+      size_t popped = 0;
+      for_each_segment(current_tail, n, [&](size_t idx, size_t count) {
+        std::memcpy(out.subspan(popped).data(), get_ptr(idx),
+                    count * sizeof(T));
+        popped += count;
+      });
+      publish_tail(current_tail, n);
+      return n;
+    }
+
+    size_t popped = 0;
+    try {
+      for_each_segment(current_tail, n, [&](size_t idx, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+          T *element_ptr = get_ptr(idx + i);
+          out[popped] = std::move(*element_ptr);
+          element_ptr->~T();
+          ++popped;
+        }
+      });
+    } catch (...) {
+      publish_tail(current_tail, popped);
+      throw;
+    }
+    publish_tail(current_tail, popped);
+    return popped;
+  }
+
+  template <typename Func> size_t consume_n(size_t max, Func &&processor) {
+    return consume_up_to(max, std::forward<Func>(processor));
+  }
+
+  // Burst consumption: passes up to `max` ready elements, oldest first, to
+  // processor(T&&) and destroys each one afterwards. The head is loaded at
+  // most once per call, the slot PrefetchDistance elements ahead is
+  // prefetched before each call to processor, and the tail is published
+  // every PublishEvery elements (0: once at the end). If processor throws,
+  // the elements already consumed are published before the exception
+  // propagates. Returns the number consumed
+  template <size_t PrefetchDistance = 4, size_t PublishEvery = 0,
+            typename Func>
+  size_t consume_up_to(size_t max, Func &&processor) {
+    const size_t current_tail = consumer_tail();
+    const size_t n = std::min(max, consumer_available(current_tail, max));
+
+    size_t consumed = 0;
+    size_t published = 0;
+    try {
+      for_each_segment(current_tail, n, [&](size_t idx, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+          if constexpr (PrefetchDistance > 0) {
+            if (consumed + PrefetchDistance < n) {
+              detail::prefetch(get_ptr(idx + i + PrefetchDistance));
+            }
+          }
+          T *element_ptr = get_ptr(idx + i);
+          processor(std::move(*element_ptr));
+          element_ptr->~T();
+          ++consumed;
+          if constexpr (PublishEvery > 0) {
+            if (consumed - published == PublishEvery) {
+              publish_tail(current_tail + published, PublishEvery);
+              published = consumed;
+            }
+          }
+        }
+      });
+    } catch (...) {
+      publish_tail(current_tail + published, consumed - published);
+      throw;
+    }
+    publish_tail(current_tail + published, consumed - published);
+    return consumed;
+  }
+
+  // consume_up_to() for everything the producer has published so far
+  template <size_t PrefetchDistance = 4, size_t PublishEvery = 0,
+            typename Func>
+  size_t consume_all(Func &&processor) {
+    return consume_up_to<PrefetchDistance, PublishEvery>(
+        capacity(), std::forward<Func>(processor));
+  }
+
+  // Zero-copy two-phase operations. reserve() and peek() expose ring memory
+  // directly and never cross the wrap point, so they may return fewer slots
+  // than requested even when more are free or ready; call them again after
+  // commit()/release() to get the segment at the start of the ring.
+
+  // Producer: up to n contiguous slots of uninitialized storage. Construct
+  // elements in order with std::construct_at, then publish them with commit()
+  [[nodiscard]] std::span<T> reserve(size_t n) noexcept {
+    const size_t current_head = producer_head();
+    const size_t contiguous = std::min(n, contiguous_from(current_head));
+    const size_t count =
+        std::min(contiguous, producer_free(current_head, contiguous));
+    return {get_ptr(current_head), count};
+  }
+
+  // Producer: publish the first k slots of the last reserve(), which must all
+  // have been constructed
+  void commit(size_t k) noexcept {
+    const size_t current_head = producer_head();
+    publish_head(current_head, k);
+  }
+
+  // Consumer: up to n contiguous ready elements, valid until release()
+  [[nodiscard]] std::span<const T> peek(size_t n) noexcept {
+    const size_t current_tail = consumer_tail();
+    const size_t contiguous = std::min(n, contiguous_from(current_tail));
+    const size_t count =
+        std::min(contiguous, consumer_available(current_tail, contiguous));
+    return {get_ptr(current_tail), count};
+  }
+
+  // Consumer: destroy the first k elements of the last peek() and hand their
+  // slots back to the producer
+  void release(size_t k) noexcept {
+    const size_t current_tail = consumer_tail();
+    std::destroy_n(get_ptr(current_tail), k);
+    publish_tail(current_tail, k);
+  }
+
+  // Blocking operations. They retry the matching try_ operation and let the
+  // wait strategy decide how to wait in between. push_wait* must only be
+  // called from the producer thread and pop_wait* from the consumer thread.
+  // try_push only consumes `item` on success, so it is safe to forward it on
+  // every retry. The timed variants sleep through the strategy's
+  // wait_for_*_until hooks where it has them (AtomicWait, EventFdWait) and
+  // spin with pause() otherwise.
+
+  template <typename U>
+    requires std::convertible_to<U, T>
+  void push_wait(U &&item) {
+    unsigned attempt = 0;
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    while (!try_push(std::forward<U>(item))) {
+      _wait.wait_for_space(_tail, _cached_tail, attempt);
+    }
+  }
+
+  template <typename U, typename Clock, typename Duration>
+    requires std::convertible_to<U, T>
+  bool push_wait_until(
+      U &&item, const std::chrono::time_point<Clock, Duration> &deadline) {
+    unsigned attempt = 0;
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    while (!try_push(std::forward<U>(item))) {
+      if (Clock::now() >= deadline) {
+        return false;
+      }
+      if constexpr (requires {
+                      _wait.wait_for_space_until(_tail, _cached_tail, attempt,
+                                                 deadline);
+                    }) {
+        _wait.wait_for_space_until(_tail, _cached_tail, attempt, deadline);
+      } else {
+        wait_strategy::pause(attempt);
+      }
+    }
+    return true;
+  }
+
+  template <typename U, typename Rep, typename Period>
+    requires std::convertible_to<U, T>
+  bool push_wait_for(U &&item,
+                     const std::chrono::duration<Rep, Period> &timeout) {
+    return push_wait_until(std::forward<U>(item),
+                           std::chrono::steady_clock::now() + timeout);
+  }
+
+  [[nodiscard]] T pop_wait() {
+    unsigned attempt = 0;
+    while (true) {
+      std::optional<T> result = try_pop();
+      if (result.has_value()) {
+        return std::move(*result);
+      }
+      _wait.wait_for_data(_head, _cached_head, attempt);
+    }
+  }
+
+  template <typename Clock, typename Duration>
+  [[nodiscard]] std::optional<T>
+  pop_wait_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+    unsigned attempt = 0;
+    while (true) {
+      std::optional<T> result = try_pop();
+      if (result.has_value() || Clock::now() >= deadline) {
+        return result;
+      }
+      if constexpr (requires {
+                      _wait.wait_for_data_until(_head, _cached_head, attempt,
+                                                deadline);
+                    }) {
+        _wait.wait_for_data_until(_head, _cached_head, attempt, deadline);
+      } else {
+        wait_strategy::pause(attempt);
+      }
+    }
+  }
+
+  template <typename Rep, typename Period>
+  [[nodiscard]] std::optional<T>
+  pop_wait_for(const std::chrono::duration<Rep, Period> &timeout) {
+    return pop_wait_until(std::chrono::steady_clock::now() + timeout);
+  }
+
+  // Event-loop integration, only with the EventFdWait strategy. Consumer
+  // side: drain the ring, then call arm_notification(). If it returns true,
+  // go back to the loop and wait for native_handle() to become readable, then
+  // call acknowledge_notification() and drain again. If it returns false, new
+  // data arrived in the meantime; keep draining.
+
+  [[nodiscard]] int native_handle() const noexcept
+    requires requires(const wait_strategy &wait) { wait.native_handle(); }
+  {
+    return _wait.native_handle();
+  }
+
+  [[nodiscard]] bool arm_notification() noexcept
+    requires requires(wait_strategy &wait, const std::atomic<size_t> &index) {
+      wait.arm(index, size_t{});
+    }
+  {
+    flush_tail();
+    return _wait.arm(_head, consumer_tail());
+  }
+
+  void acknowledge_notification() noexcept
+    requires requires(const wait_strategy &wait) { wait.acknowledge(); }
+  {
+    _wait.acknowledge();
+  }
+
+  // Awaitables returned by async_pop/async_push. They try the operation in
+  // await_ready and only suspend if it fails; the other side's next publish
+  // then hands the coroutine to Executor. SPSC guarantees a published
+  // element (or free slot) is still there when it resumes, so the retry in
+  // await_resume cannot fail unless a second consumer (or producer) took it.
+  // That breaks the ring's contract and throws std::logic_error rather than
+  // making up an element or dropping the one to push
+  template <typename Executor> class PopAwaiter : detail::CoroutineWaiter {
+    BasicRingBuffer &_ring;
+    [[no_unique_address]] Executor _executor;
+    std::optional<T> _result;
+
+    static void resume_on_executor(detail::CoroutineWaiter &waiter) noexcept {
+      auto &self = static_cast<PopAwaiter &>(waiter);
+      self._executor(self.handle);
+    }
+
+  public:
+    PopAwaiter(BasicRingBuffer &ring, Executor executor)
+        : detail::CoroutineWaiter{{}, &resume_on_executor, 0}, _ring(ring),
+          _executor(std::move(executor)) {}
+    PopAwaiter(const PopAwaiter &) = delete;
+    PopAwaiter &operator=(const PopAwaiter &) = delete;
+    PopAwaiter(PopAwaiter &&) = delete;
+    PopAwaiter &operator=(PopAwaiter &&) = delete;
+    ~PopAwaiter() = default;
+
+    bool await_ready() {
+      _result = _ring.try_pop();
+      return _result.has_value();
+    }
+    bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+      handle = awaiting;
+      return _ring._wait.suspend_for_data(*this, _ring._head,
+                                          _ring._cached_head);
+    }
+    T await_resume() {
+      if (!_result) {
+        _result = _ring.try_pop();
+        if (!_result) {
+          throw std::logic_error(
+              "RingBuffer: async_pop resumed without an element; is there "
+              "a second consumer?");
+        }
+      }
+      return std::move(*_result);
+    }
+  };
+
+  template <typename Executor> class PushAwaiter : detail::CoroutineWaiter {
+    BasicRingBuffer &_ring;
+    [[no_unique_address]] Executor _executor;
+    T _item;
+    bool _pushed{false};
+
+    static void resume_on_executor(detail::CoroutineWaiter &waiter) noexcept {
+      auto &self = static_cast<PushAwaiter &>(waiter);
+      self._executor(self.handle);
+    }
+
+  public:
+    PushAwaiter(BasicRingBuffer &ring, T item, Executor executor)
+        : detail::CoroutineWaiter{{}, &resume_on_executor, 0}, _ring(ring),
+          _executor(std::move(executor)), _item(std::move(item)) {}
+    PushAwaiter(const PushAwaiter &) = delete;
+    PushAwaiter &operator=(const PushAwaiter &) = delete;
+    PushAwaiter(PushAwaiter &&) = delete;
+    PushAwaiter &operator=(PushAwaiter &&) = delete;
+    ~PushAwaiter() = default;
+
+    bool await_ready() {
+      _pushed = _ring.try_push(std::move(_item));
+      return _pushed;
+    }
+    bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+      handle = awaiting;
+      return _ring._wait.suspend_for_space(*this, _ring._tail,
+                                           _ring._cached_tail);
+    }
+    void await_resume() {
+      if (!_pushed) {
+        // try_push only moves from _item on success
+        // NOLINTNEXTLINE(bugprone-use-after-move)
+        _pushed = _ring.try_push(std::move(_item));
+        if (!_pushed) {
+          throw std::logic_error(
+              "RingBuffer: async_push resumed without a free slot; is there "
+              "a second producer?");
+        }
+      }
+    }
+  };
+
+  // Coroutine operations, only with the CoroutineWait strategy. At most one
+  // coroutine may await each side at a time, as with the other operations.
+  // The waiting coroutine is resumed by passing its handle to `executor`,
+  // which by default resumes it inline, inside the other side's push or pop
+  // call. Pass an executor that posts the handle to the waiter's own event
+  // loop when the two sides run on different threads.
+  //
+  //   T value = co_await ring.async_pop();
+  //   co_await ring.async_push(std::move(value), post_to_io_loop);
+
+  template <typename Executor = InlineResume>
+    requires coroutine_wait && std::invocable<Executor &, std::coroutine_handle<>>
+  [[nodiscard]] PopAwaiter<Executor> async_pop(Executor executor = {}) {
+    return PopAwaiter<Executor>(*this, std::move(executor));
+  }
+
+  template <typename U, typename Executor = InlineResume>
+    requires coroutine_wait && std::convertible_to<U, T> &&
+             std::invocable<Executor &, std::coroutine_handle<>>
+  [[nodiscard]] PushAwaiter<Executor> async_push(U &&item,
+                                                 Executor executor = {}) {
+    return PushAwaiter<Executor>(*this, T(std::forward<U>(item)),
+                                 std::move(executor));
+  }
 };
+
+template <RingElement T, size_t Capacity, Policy... Policies>
+using RingBuffer = BasicRingBuffer<T, StaticCapacity<Capacity>, Policies...>;
+
+// Runtime-sized ring. The capacity is passed to the constructor and must be a
+// power of two; std::invalid_argument is thrown otherwise
+template <RingElement T, Policy... Policies>
+using DynamicRingBuffer = BasicRingBuffer<T, DynamicCapacity, Policies...>;
+
 } // namespace bring
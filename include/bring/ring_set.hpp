@@ -0,0 +1,268 @@
+#pragma once
+#include "ring_buffer.hpp"
+#include "wait_strategy.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace bring {
+
+namespace detail {
+
+// Shared by a RingSet and its rings' RingSetNotify strategies: the set's
+// consumer sleeps on `epoch` while `parked` is set. The set puts it on its
+// own line
+struct RingSetWake {
+  std::atomic<bool> parked{false};
+  std::atomic<uint32_t> epoch{0};
+};
+
+} // namespace detail
+
+// Wait strategy of the rings in a RingSet. After every publish it marks the
+// ring in the set's ready mask, unless it is already marked, and wakes the
+// set's consumer if it sleeps. Marking follows AtomicWait's protocol: the
+// producer fences and reads the mask; it only writes it when the ring goes
+// from idle to ready, so a busy ring pays a fence and a load per publish.
+// Blocking push_wait/pop_wait on a single ring spin and yield like
+// SpinYieldWait. A ring that is not bound to a set behaves like SpinYieldWait
+class RingSetNotify {
+  std::atomic<uint64_t> *_word{nullptr};
+  uint64_t _bit{0};
+  detail::RingSetWake *_wake{nullptr};
+
+public:
+  using policy_kind = policy_kind::wait;
+
+  void bind(std::atomic<uint64_t> &word, uint64_t bit,
+            detail::RingSetWake &wake) noexcept {
+    _word = &word;
+    _bit = bit;
+    _wake = &wake;
+  }
+
+  static void pause(unsigned &attempt) noexcept {
+    SpinYieldWait<>::pause(attempt);
+  }
+
+  static void wait_for_data(const std::atomic<size_t> & /*head*/,
+                            size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+  static void wait_for_space(const std::atomic<size_t> & /*tail*/,
+                             size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+
+  void notify_data(std::atomic<size_t> & /*head*/) noexcept {
+    if (_word == nullptr) {
+      return;
+    }
+    // Pairs with the fence in RingSet::retire(): either the consumer sees
+    // the new head after clearing the bit, or we see the bit cleared here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((_word->load(std::memory_order_relaxed) & _bit) != 0) {
+      return;
+    }
+    _word->fetch_or(_bit, std::memory_order_relaxed);
+    // Pairs with the fence in RingSet::wait_for_any()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_wake->parked.load(std::memory_order_relaxed)) {
+      _wake->epoch.fetch_add(1, std::memory_order_relaxed);
+      _wake->epoch.notify_one();
+    }
+  }
+
+  static void notify_space(std::atomic<size_t> & /*tail*/) noexcept {}
+};
+
+// Fan-in of Rings SPSC rings into one consumer thread. Each ring has its own
+// producer; ring(i) gives producer i its ring.
+//
+// Producers mark their ring in a ready bitmask when it goes from idle to
+// ready, so the consumer finds work by scanning one word per 64 rings
+// instead of loading every ring's head. A ring's bit is cleared when a pass
+// finds the ring empty. Each poll() visits the ready rings round-robin,
+// starting after the ring where the previous poll() started, and takes at
+// most batch_limit(i) elements from ring i; unequal limits give rings
+// weighted shares of the consumer. poll_wait() sleeps on a futex when no
+// ring is ready.
+//
+// The price is on the producer side: every publish pays a seq_cst fence
+// before it reads the mask, even when its ring is already marked. Without
+// it the head store could still sit in the producer's store buffer while
+// the consumer clears the bit and re-checks the head, and each would miss
+// the other. The producer cannot spot the idle-to-ready transition on its
+// own either, since its cached tail only bounds the occupancy from above.
+// So with many busy rings that get one element per pass, a hand-written
+// loop over every ring's head is faster; the set wins when most rings are
+// idle, or when producers publish in batches (try_push_n, DeferredPublish)
+// and pay the fence once per batch
+//
+// The consumer operations (poll, poll_wait, wait_for_any, any_ready) must
+// all be called from one thread. Policies... are passed on to the rings and
+// must not contain a wait strategy
+template <RingElement T, size_t Capacity, size_t Rings, Policy... Policies>
+class RingSet {
+public:
+  using ring_type = RingBuffer<T, Capacity, RingSetNotify, Policies...>;
+
+private:
+  static_assert(Rings > 0, "RingSet needs at least one ring");
+  static_assert(
+      std::same_as<typename ring_type::wait_strategy, RingSetNotify>,
+      "RingSet rings use RingSetNotify; do not pass a wait strategy");
+
+  static constexpr size_t bits_per_word{64};
+  static constexpr size_t words{(Rings + bits_per_word - 1) / bits_per_word};
+  // The rings' line size, so a padding policy in Policies... pads the set
+  static constexpr size_t align_size{ring_type::padding_policy::line_size};
+  static constexpr unsigned spin_limit{64};
+  static constexpr size_t default_batch_limit{64};
+
+  // Written by producers on idle-to-ready transitions, read by the consumer
+  alignas(align_size) std::array<std::atomic<uint64_t>, words> _ready{};
+  alignas(align_size) detail::RingSetWake _wake;
+
+  // Consumer only
+  alignas(align_size) std::array<size_t, Rings> _batch_limits{};
+  size_t _cursor{0};
+
+  std::array<ring_type, Rings> _rings;
+
+  // Clears ring i's bit after a drain left it empty. If the producer
+  // published meanwhile, the bit is set again and the ring stays ready
+  void retire(size_t i) noexcept {
+    const uint64_t bit = uint64_t{1} << (i % bits_per_word);
+    std::atomic<uint64_t> &word = _ready.at(i / bits_per_word);
+    word.fetch_and(~bit, std::memory_order_relaxed);
+    // Pairs with the fence in RingSetNotify::notify_data()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_rings.at(i).is_empty()) {
+      word.fetch_or(bit, std::memory_order_relaxed);
+    }
+  }
+
+  // Drains ring i up to its batch limit. A ring is only retired when a pass
+  // finds it empty, so one that keeps receiving between passes stays marked
+  // and its producer never writes the mask
+  template <typename Func> size_t drain(size_t i, Func &processor) {
+    const size_t consumed = _rings.at(i).consume_up_to(
+        _batch_limits.at(i), [&](T &&item) { processor(i, std::move(item)); });
+    if (consumed == 0) {
+      retire(i);
+    }
+    return consumed;
+  }
+
+  // Drains the ready rings in [first, last)
+  template <typename Func>
+  size_t drain_range(size_t first, size_t last, Func &processor) {
+    size_t total = 0;
+    for (size_t w = first / bits_per_word; w * bits_per_word < last; ++w) {
+      uint64_t bits = _ready.at(w).load(std::memory_order_acquire);
+      while (bits != 0) {
+        const size_t i =
+            w * bits_per_word + static_cast<size_t>(std::countr_zero(bits));
+        bits &= bits - 1;
+        if (i >= first && i < last) {
+          total += drain(i, processor);
+        }
+      }
+    }
+    return total;
+  }
+
+public:
+  RingSet() {
+    _batch_limits.fill(default_batch_limit);
+    for (size_t i = 0; i < Rings; ++i) {
+      _rings.at(i).waiter().bind(_ready.at(i / bits_per_word),
+                                 uint64_t{1} << (i % bits_per_word), _wake);
+    }
+  }
+
+  ~RingSet() = default;
+
+  // Rings hold pointers into the set
+  RingSet(const RingSet &) = delete;
+  RingSet &operator=(const RingSet &) = delete;
+  RingSet(RingSet &&) = delete;
+  RingSet &operator=(RingSet &&) = delete;
+
+  [[nodiscard]] static constexpr size_t rings() noexcept { return Rings; }
+
+  // Ring i, for its producer. The consumer side of the rings belongs to the
+  // set; do not pop from them directly
+  [[nodiscard]] ring_type &ring(size_t i) { return _rings.at(i); }
+
+  // Consumer operations. Only one thread may call these
+
+  [[nodiscard]] size_t batch_limit(size_t i) const {
+    return _batch_limits.at(i);
+  }
+
+  // Most elements one poll() takes from ring i. Throws std::invalid_argument
+  // for 0
+  void set_batch_limit(size_t i, size_t limit) {
+    if (limit == 0) {
+      throw std::invalid_argument("RingSet batch limit must be at least 1");
+    }
+    _batch_limits.at(i) = limit;
+  }
+
+  // True if some ring may hold elements. Loads only the ready mask
+  [[nodiscard]] bool any_ready() const noexcept {
+    return std::any_of(_ready.begin(), _ready.end(),
+                       [](const std::atomic<uint64_t> &word) {
+                         return word.load(std::memory_order_relaxed) != 0;
+                       });
+  }
+
+  // One round-robin pass over the ready rings. Passes each element to
+  // processor(size_t ring_index, T&&) and returns the number consumed
+  template <typename Func> size_t poll(Func &&processor) {
+    const size_t start = _cursor;
+    _cursor = (_cursor + 1) % Rings;
+    return drain_range(start, Rings, processor) +
+           drain_range(0, start, processor);
+  }
+
+  // Blocks until some ring is ready: spins, then sleeps until a producer
+  // marks a ring. May return spuriously
+  void wait_for_any() noexcept {
+    for (unsigned attempt = 0; attempt < spin_limit; ++attempt) {
+      if (any_ready()) {
+        return;
+      }
+      cpu_relax();
+    }
+    const uint32_t epoch = _wake.epoch.load(std::memory_order_relaxed);
+    _wake.parked.store(true, std::memory_order_relaxed);
+    // Pairs with the second fence in RingSetNotify::notify_data()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!any_ready()) {
+      _wake.epoch.wait(epoch, std::memory_order_relaxed);
+    }
+    _wake.parked.store(false, std::memory_order_relaxed);
+  }
+
+  // poll(), waiting first if no ring has anything. Returns at least one
+  // element
+  template <typename Func> size_t poll_wait(Func &&processor) {
+    while (true) {
+      if (const size_t consumed = poll(processor); consumed > 0) {
+        return consumed;
+      }
+      wait_for_any();
+    }
+  }
+};
+
+} // namespace bring
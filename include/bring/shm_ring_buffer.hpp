@@ -0,0 +1,306 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "bring/shm_ring_buffer.hpp requires POSIX shared memory"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bring {
+
+// SPSC ring whose indices and slots live in a POSIX shared memory object, so
+// the producer and the consumer can be different processes. It uses the same
+// protocol as RingBuffer: free-running head/tail counters, each side keeping
+// a process-local cached copy of the other side's index.
+//
+// One process calls create(name), the other attach(name). The mapping starts
+// with a header recording the layout (version, element size and alignment,
+// capacity, offsets); attach() rejects a mapping written by a build with a
+// different layout. Elements are copied byte-wise between processes, so T
+// must be trivially copyable, and no pointers inside T are meaningful on the
+// other side
+template <typename T, size_t Capacity> class ShmRingBuffer {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "ShmRingBuffer elements must be trivially copyable");
+  // Lock-free atomics are the ones the standard expects to be address-free,
+  // i.e. to work when the same memory is mapped at different addresses in
+  // different processes
+  static_assert(std::atomic<size_t>::is_always_lock_free,
+                "ShmRingBuffer needs lock-free size_t atomics");
+  static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                "ShmRingBuffer needs lock-free uint32_t atomics");
+
+  using Extent = StaticCapacity<Capacity>;
+  using Slot = detail::Slot<T>;
+
+  static constexpr size_t align_size{64};
+  static constexpr uint64_t magic{0x4d48532d474e4952}; // "RING-SHM"
+  static constexpr uint32_t version{1};
+
+  enum : uint32_t { initializing = 0, ready = 1 };
+
+  struct Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t index_size;
+    uint64_t element_size;
+    uint64_t element_align;
+    uint64_t capacity;
+    uint64_t slots_offset;
+    uint64_t mapping_size;
+    // Written last by create(); attach() refuses a mapping until it is ready
+    std::atomic<uint32_t> state;
+  };
+
+  struct ControlBlock {
+    alignas(align_size) Header header;
+    alignas(align_size) std::atomic<size_t> head;
+    alignas(align_size) std::atomic<size_t> tail;
+  };
+
+  // Slots start on their own cache line after the control block
+  static constexpr size_t slot_align{std::max(align_size, alignof(Slot))};
+  static constexpr size_t slots_offset{
+      (sizeof(ControlBlock) + slot_align - 1) / slot_align * slot_align};
+  static constexpr size_t mapping_size{slots_offset + sizeof(Slot) * Capacity};
+
+  ControlBlock *_control{nullptr};
+  Slot *_slots{nullptr};
+  std::string _name;
+  bool _owner{false};
+
+  // Process-local copies of the other side's index, as in RingBuffer
+  alignas(align_size) size_t _cached_tail{0};
+  alignas(align_size) size_t _cached_head{0};
+
+  ShmRingBuffer(void *mapping, std::string name, bool owner)
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      : _control(reinterpret_cast<ControlBlock *>(mapping)),
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        _slots(reinterpret_cast<Slot *>(static_cast<std::byte *>(mapping) +
+                                        slots_offset)),
+        _name(std::move(name)), _owner(owner) {
+    _cached_tail = _control->tail.load(std::memory_order_acquire);
+    _cached_head = _control->head.load(std::memory_order_acquire);
+  }
+
+  [[noreturn]] static void throw_errno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+  }
+
+  static void *map_fd(int fd) {
+    void *mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+      const int saved = errno;
+      ::close(fd);
+      errno = saved;
+      throw_errno("mmap");
+    }
+    ::close(fd);
+    return mapping;
+  }
+
+  static void check_layout(const Header &header) {
+    const bool matches =
+        header.magic == magic && header.version == version &&
+        header.index_size == sizeof(size_t) &&
+        header.element_size == sizeof(T) &&
+        header.element_align == alignof(T) && header.capacity == Capacity &&
+        header.slots_offset == slots_offset &&
+        header.mapping_size == mapping_size;
+    if (!matches) {
+      throw std::runtime_error(
+          "ShmRingBuffer: shared memory layout does not match this build");
+    }
+  }
+
+  T *get_ptr(size_t idx) noexcept {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return _slots[idx & Extent::mask()].get();
+  }
+
+  void release_mapping() noexcept {
+    if (_control != nullptr) {
+      ::munmap(_control, mapping_size);
+      if (_owner) {
+        ::shm_unlink(_name.c_str());
+      }
+      _control = nullptr;
+      _slots = nullptr;
+    }
+  }
+
+public:
+  // Creates the shared memory object `name` (e.g. "/feed_ticks") and
+  // initializes an empty ring in it. Fails if the object already exists. The
+  // returned ring unlinks the name when it is destroyed
+  [[nodiscard]] static ShmRingBuffer create(const std::string &name) {
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      throw_errno("shm_open");
+    }
+    if (::ftruncate(fd, static_cast<off_t>(mapping_size)) != 0) {
+      const int saved = errno;
+      ::close(fd);
+      ::shm_unlink(name.c_str());
+      errno = saved;
+      throw_errno("ftruncate");
+    }
+    void *mapping = nullptr;
+    try {
+      mapping = map_fd(fd);
+    } catch (...) {
+      ::shm_unlink(name.c_str());
+      throw;
+    }
+
+    auto *control = new (mapping) ControlBlock{};
+    Header &header = control->header;
+    header.magic = magic;
+    header.version = version;
+    header.index_size = sizeof(size_t);
+    header.element_size = sizeof(T);
+    header.element_align = alignof(T);
+    header.capacity = Capacity;
+    header.slots_offset = slots_offset;
+    header.mapping_size = mapping_size;
+    header.state.store(ready, std::memory_order_release);
+    return ShmRingBuffer(mapping, name, true);
+  }
+
+  // Maps a ring another process created with create(name). Throws
+  // std::system_error if it does not exist and std::runtime_error if it was
+  // created by a build with a different layout or is still being initialized
+  [[nodiscard]] static ShmRingBuffer attach(const std::string &name) {
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      throw_errno("shm_open");
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+      const int saved = errno;
+      ::close(fd);
+      errno = saved;
+      throw_errno("fstat");
+    }
+    if (static_cast<size_t>(info.st_size) != mapping_size) {
+      ::close(fd);
+      throw std::runtime_error(
+          "ShmRingBuffer: shared memory size does not match this build");
+    }
+
+    void *mapping = map_fd(fd);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto *control = reinterpret_cast<ControlBlock *>(mapping);
+    try {
+      if (control->header.state.load(std::memory_order_acquire) != ready) {
+        throw std::runtime_error("ShmRingBuffer: ring is not initialized yet");
+      }
+      check_layout(control->header);
+    } catch (...) {
+      ::munmap(mapping, mapping_size);
+      throw;
+    }
+    return ShmRingBuffer(mapping, name, false);
+  }
+
+  ~ShmRingBuffer() { release_mapping(); }
+
+  ShmRingBuffer(const ShmRingBuffer &) = delete;
+  ShmRingBuffer &operator=(const ShmRingBuffer &) = delete;
+
+  ShmRingBuffer(ShmRingBuffer &&other) noexcept
+      : _control(std::exchange(other._control, nullptr)),
+        _slots(std::exchange(other._slots, nullptr)),
+        _name(std::move(other._name)),
+        _owner(std::exchange(other._owner, false)),
+        _cached_tail(other._cached_tail), _cached_head(other._cached_head) {}
+
+  ShmRingBuffer &operator=(ShmRingBuffer &&other) noexcept {
+    if (this != &other) {
+      release_mapping();
+      _control = std::exchange(other._control, nullptr);
+      _slots = std::exchange(other._slots, nullptr);
+      _name = std::move(other._name);
+      _owner = std::exchange(other._owner, false);
+      _cached_tail = other._cached_tail;
+      _cached_head = other._cached_head;
+    }
+    return *this;
+  }
+
+  [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+  [[nodiscard]] const std::string &name() const noexcept { return _name; }
+
+  [[nodiscard]] size_t size() const noexcept {
+    const size_t current_tail = _control->tail.load(std::memory_order_acquire);
+    const size_t current_head = _control->head.load(std::memory_order_acquire);
+    return std::min(current_head - current_tail, Capacity);
+  }
+
+  [[nodiscard]] bool is_empty() const noexcept { return size() == 0; }
+  [[nodiscard]] bool is_full() const noexcept { return size() == Capacity; }
+
+  // Producer operations. Only one thread, in one process, may call these
+
+  bool try_push(const T &item) noexcept {
+    const size_t current_head =
+        _control->head.load(std::memory_order_relaxed);
+    if (current_head - _cached_tail == Capacity) {
+      _cached_tail = _control->tail.load(std::memory_order_acquire);
+      if (current_head - _cached_tail == Capacity) {
+        return false;
+      }
+    }
+    std::memcpy(get_ptr(current_head), &item, sizeof(T));
+    _control->head.store(current_head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer operations. Only one thread, in one process, may call these
+
+  // Passes the next element to processor(const T&) in place
+  template <typename Func> bool try_consume(Func &&processor) {
+    const size_t current_tail =
+        _control->tail.load(std::memory_order_relaxed);
+    if (current_tail == _cached_head) {
+      _cached_head = _control->head.load(std::memory_order_acquire);
+      if (current_tail == _cached_head) {
+        return false;
+      }
+    }
+    std::forward<Func>(processor)(std::as_const(*get_ptr(current_tail)));
+    _control->tail.store(current_tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop_ip(T &out) noexcept {
+    return try_consume([&out](const T &item) { out = item; });
+  }
+
+  [[nodiscard]] std::optional<T> try_pop() noexcept {
+    std::optional<T> result;
+    try_consume([&result](const T &item) { result.emplace(item); });
+    return result;
+  }
+};
+
+} // namespace bring
@@ -0,0 +1,108 @@
+#pragma once
+#include "padding.hpp"
+#include "policy.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace bring {
+
+// Stats policies receive a hook for every push, pop and failed attempt:
+//   on_push(n) / on_pop(n)                 - n elements were published
+//   on_push_full() / on_pop_empty()        - a call found the ring full/empty
+//   on_producer_sync(occupancy)            - producer reloaded the tail
+//   on_consumer_sync(occupancy)            - consumer reloaded the head
+// Producer hooks run on the producer thread and consumer hooks on the consumer
+// thread. The sync hooks report the exact occupancy at the moment one side
+// refreshed its cached copy of the other side's index, which is the only time
+// a side knows it without touching the other side's cache line.
+
+// Default. Every hook is an empty inline function, so the calls compile away
+struct NoStats {
+  using policy_kind = policy_kind::stats;
+
+  static void on_push(size_t /*count*/) noexcept {}
+  static void on_push_full() noexcept {}
+  static void on_producer_sync(size_t /*occupancy*/) noexcept {}
+  static void on_pop(size_t /*count*/) noexcept {}
+  static void on_pop_empty() noexcept {}
+  static void on_consumer_sync(size_t /*occupancy*/) noexcept {}
+};
+
+struct RingStatsSnapshot {
+  uint64_t pushes;
+  uint64_t pops;
+  uint64_t push_full;
+  uint64_t pop_empty;
+  // Highest occupancy seen at a sync point, so it under-reports: never above
+  // the true peak, but short of it by up to the elements the consumer popped
+  // since it last loaded the head. Sampling on every publish would cost the
+  // load of the other side's index that the cached copies exist to avoid; a
+  // monitor that needs the exact peak can poll size() instead
+  uint64_t high_watermark;
+};
+
+// Counting policy. Each side's counters sit on that side's own cache line and
+// have a single writer, so updates are plain relaxed load + store with no
+// read-modify-write. A third thread (e.g. a metrics exporter) may call
+// snapshot() at any time; the counters are read individually, so a snapshot
+// taken while the ring is in use is not a consistent cut across them. The
+// two sides' counters are LineSize bytes apart; a ring replaces LineSize
+// with its padding policy's line size
+template <size_t LineSize = destructive_interference_size>
+class BasicRingStats {
+  static constexpr size_t align_size{LineSize};
+
+  struct alignas(align_size) SideCounters {
+    std::atomic<uint64_t> _completed{0};
+    std::atomic<uint64_t> _failed{0};
+    std::atomic<uint64_t> _watermark{0};
+  };
+
+  SideCounters _producer;
+  SideCounters _consumer;
+
+  static void bump(std::atomic<uint64_t> &counter, uint64_t by) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + by,
+                  std::memory_order_relaxed);
+  }
+
+  static void raise(std::atomic<uint64_t> &watermark, uint64_t value) noexcept {
+    if (value > watermark.load(std::memory_order_relaxed)) {
+      watermark.store(value, std::memory_order_relaxed);
+    }
+  }
+
+public:
+  using policy_kind = policy_kind::stats;
+  template <size_t Line> using padded = BasicRingStats<Line>;
+
+  void on_push(size_t count) noexcept { bump(_producer._completed, count); }
+  void on_push_full() noexcept { bump(_producer._failed, 1); }
+  void on_producer_sync(size_t occupancy) noexcept {
+    raise(_producer._watermark, occupancy);
+  }
+
+  void on_pop(size_t count) noexcept { bump(_consumer._completed, count); }
+  void on_pop_empty() noexcept { bump(_consumer._failed, 1); }
+  void on_consumer_sync(size_t occupancy) noexcept {
+    raise(_consumer._watermark, occupancy);
+  }
+
+  [[nodiscard]] RingStatsSnapshot snapshot() const noexcept {
+    return RingStatsSnapshot{
+        .pushes = _producer._completed.load(std::memory_order_relaxed),
+        .pops = _consumer._completed.load(std::memory_order_relaxed),
+        .push_full = _producer._failed.load(std::memory_order_relaxed),
+        .pop_empty = _consumer._failed.load(std::memory_order_relaxed),
+        .high_watermark =
+            std::max(_producer._watermark.load(std::memory_order_relaxed),
+                     _consumer._watermark.load(std::memory_order_relaxed)),
+    };
+  }
+};
+
+using RingStats = BasicRingStats<>;
+
+} // namespace bring
@@ -0,0 +1,157 @@
+#pragma once
+#include "policy.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace bring {
+
+// Storage policies decide where a ring's slot array lives. Each policy names
+// a nested template `storage<Slot, CapacityPolicy>` that the ring instantiates
+// with its slot type and capacity policy. A storage provides:
+//   storage(count, args...)  - allocate `count` slots
+//   operator[](i)            - access slot i
+// and must be nothrow-movable. Slots are raw bytes; the ring constructs and
+// destroys the elements inside them. A storage whose slots live inside the
+// storage object itself sets `static constexpr bool is_inline = true`; moving
+// it does not carry the elements along, so the ring moves them one by one.
+
+// Default. One heap allocation through std::make_unique
+struct HeapStorage {
+  using policy_kind = policy_kind::storage;
+
+  template <typename Slot, typename /*CapacityPolicy*/> class storage {
+    // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+    std::unique_ptr<Slot[]> _slots;
+
+  public:
+    explicit storage(size_t count)
+        // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays)
+        : _slots(std::make_unique<Slot[]>(count)) {}
+
+    Slot &operator[](size_t idx) const noexcept { return _slots[idx]; }
+  };
+};
+
+// Allocates the slot array from a std::pmr::memory_resource passed to the
+// ring's constructor, e.g. a MappedMemoryResource for huge pages or NUMA-local
+// memory. The array is aligned to at least a cache line. The resource must
+// outlive the ring, and a moved-to ring keeps the resource of its source
+struct ResourceStorage {
+  using policy_kind = policy_kind::storage;
+
+  template <typename Slot, typename /*CapacityPolicy*/> class storage {
+    static constexpr size_t alignment{std::max<size_t>(64, alignof(Slot))};
+
+    std::pmr::memory_resource *_resource;
+    Slot *_slots;
+    size_t _count;
+
+    void release() noexcept {
+      if (_slots != nullptr) {
+        std::destroy_n(_slots, _count);
+        _resource->deallocate(_slots, _count * sizeof(Slot), alignment);
+      }
+    }
+
+  public:
+    explicit storage(size_t count, std::pmr::memory_resource *resource =
+                                       std::pmr::get_default_resource())
+        : _resource(resource),
+          _slots(static_cast<Slot *>(
+              resource->allocate(count * sizeof(Slot), alignment))),
+          _count(count) {
+      std::uninitialized_default_construct_n(_slots, _count);
+    }
+
+    ~storage() { release(); }
+
+    storage(const storage &) = delete;
+    storage &operator=(const storage &) = delete;
+
+    storage(storage &&other) noexcept
+        : _resource(other._resource),
+          _slots(std::exchange(other._slots, nullptr)),
+          _count(std::exchange(other._count, 0)) {}
+
+    storage &operator=(storage &&other) noexcept {
+      if (this != &other) {
+        release();
+        _resource = other._resource;
+        _slots = std::exchange(other._slots, nullptr);
+        _count = std::exchange(other._count, 0);
+      }
+      return *this;
+    }
+
+    Slot &operator[](size_t idx) const noexcept {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      return _slots[idx];
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+      return _resource;
+    }
+  };
+};
+
+namespace detail {
+
+template <typename CapacityPolicy>
+concept ConstantCapacity = requires {
+  typename std::integral_constant<size_t, CapacityPolicy::capacity()>;
+};
+
+template <typename Storage>
+concept InlineSlots = Storage::is_inline;
+
+} // namespace detail
+
+// Embeds the slot array in the ring object, on its own cache lines, instead
+// of allocating it. Saves the pointer load on every access and keeps the
+// slots next to the indices, so a small ring can live in static storage or
+// inside a per-thread context struct. Only for compile-time capacities
+// (RingBuffer, not DynamicRingBuffer).
+//
+// Moving a ring with inline storage move-constructs each live element into
+// the destination and leaves the source empty. It is only available when T
+// is nothrow move constructible, and costs O(size()) instead of O(1)
+struct InlineStorage {
+  using policy_kind = policy_kind::storage;
+
+  template <typename Slot, typename CapacityPolicy> class storage {
+    static_assert(detail::ConstantCapacity<CapacityPolicy>,
+                  "InlineStorage needs a compile-time capacity");
+    static constexpr size_t alignment{std::max<size_t>(64, alignof(Slot))};
+
+    alignas(alignment) std::array<Slot, CapacityPolicy::capacity()> _slots;
+
+  public:
+    static constexpr bool is_inline{true};
+
+    storage() = default;
+    explicit storage(size_t /*count*/) {}
+
+    storage(const storage &) = delete;
+    storage &operator=(const storage &) = delete;
+    // Slots are raw bytes, the ring moves the elements in them
+    storage(storage && /*other*/) noexcept {}
+    storage &operator=(storage && /*other*/) noexcept { return *this; }
+    ~storage() = default;
+
+    Slot &operator[](size_t idx) noexcept {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      return _slots[idx];
+    }
+    const Slot &operator[](size_t idx) const noexcept {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      return _slots[idx];
+    }
+  };
+};
+
+} // namespace bring
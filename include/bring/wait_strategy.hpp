@@ -0,0 +1,208 @@
+#pragma once
+#include "padding.hpp"
+#include "policy.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||             \
+    defined(_M_IX86)
+#include <immintrin.h>
+#elif defined(_M_ARM64) || defined(_M_ARM)
+#include <intrin.h>
+#endif
+
+namespace bring {
+
+// Hint to the CPU that we are in a spin loop. Lowers power and frees pipeline
+// resources for a sibling hyperthread
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||             \
+    defined(_M_IX86)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#elif defined(_M_ARM64) || defined(_M_ARM)
+  __yield();
+#endif
+}
+
+// Wait strategies decide what a blocking push_wait/pop_wait does while the
+// ring is full or empty. Each strategy provides:
+//   pause(attempt)                          - back off once, never parks
+//   wait_for_data(head, observed, attempt)  - consumer: ring looked empty
+//   wait_for_space(tail, observed, attempt) - producer: ring looked full
+//   notify_data(head) / notify_space(tail)  - called after every publish
+// `observed` is the index value that made the ring look empty/full. Waits may
+// return spuriously; the ring always re-checks. Strategies that can sleep
+// also provide the deadline-bounded versions the timed waits use:
+//   wait_for_data_until(head, observed, attempt, deadline)
+//   wait_for_space_until(tail, observed, attempt, deadline)
+// and timed waits on strategies without them spin with pause().
+
+// Busy spin with exponential pause backoff. Lowest latency, burns a full core
+struct BusySpinWait {
+  using policy_kind = policy_kind::wait;
+  static constexpr unsigned max_backoff_shift{6};
+
+  static void pause(unsigned &attempt) noexcept {
+    const unsigned spins = 1U << std::min(attempt, max_backoff_shift);
+    for (unsigned i = 0; i < spins; ++i) {
+      cpu_relax();
+    }
+    ++attempt;
+  }
+
+  static void wait_for_data(const std::atomic<size_t> & /*head*/,
+                            size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+  static void wait_for_space(const std::atomic<size_t> & /*tail*/,
+                             size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+  static void notify_data(std::atomic<size_t> & /*head*/) noexcept {}
+  static void notify_space(std::atomic<size_t> & /*tail*/) noexcept {}
+};
+
+// Spin for SpinLimit attempts, then give the core away with
+// std::this_thread::yield on every further attempt
+template <unsigned SpinLimit = 64> struct SpinYieldWait {
+  using policy_kind = policy_kind::wait;
+
+  static void pause(unsigned &attempt) noexcept {
+    if (attempt < SpinLimit) {
+      cpu_relax();
+      ++attempt;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  static void wait_for_data(const std::atomic<size_t> & /*head*/,
+                            size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+  static void wait_for_space(const std::atomic<size_t> & /*tail*/,
+                             size_t /*observed*/, unsigned &attempt) noexcept {
+    pause(attempt);
+  }
+  static void notify_data(std::atomic<size_t> & /*head*/) noexcept {}
+  static void notify_space(std::atomic<size_t> & /*tail*/) noexcept {}
+};
+
+// Spin for SpinLimit attempts, then park on the other side's index with
+// std::atomic::wait. The other side only calls notify_one when it sees the
+// parked flag, so the non-blocking path pays a fence and a flag load per
+// publish but never a syscall.
+//
+// std::atomic::wait has no timeout, so timed waits cannot park. Past
+// SpinLimit they sleep instead, in steps that start at a microsecond and
+// double up to about a millisecond, never past the deadline; a publish is
+// noticed at the end of the current step.
+//
+// The two parked flags are LineSize bytes apart; a ring replaces LineSize
+// with its padding policy's line size
+template <unsigned SpinLimit = 64,
+          size_t LineSize = destructive_interference_size>
+class AtomicWait {
+  static constexpr size_t align_size{LineSize};
+  static constexpr unsigned max_sleep_shift{10};
+  // Written by the parking side, read by the publishing side on every publish
+  alignas(align_size) std::atomic<bool> _consumer_parked{false};
+  alignas(align_size) std::atomic<bool> _producer_parked{false};
+
+  static void park(const std::atomic<size_t> &index, size_t observed,
+                   std::atomic<bool> &parked) noexcept {
+    parked.store(true, std::memory_order_relaxed);
+    // Pairs with the fence in wake(): either we see the new index here, or
+    // the publisher sees parked == true and notifies
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (index.load(std::memory_order_relaxed) == observed) {
+      index.wait(observed, std::memory_order_acquire);
+    }
+    parked.store(false, std::memory_order_relaxed);
+  }
+
+  template <typename Clock, typename Duration>
+  static void
+  sleep_until(unsigned &attempt,
+              const std::chrono::time_point<Clock, Duration> &deadline) {
+    if (attempt < SpinLimit) {
+      cpu_relax();
+      ++attempt;
+      return;
+    }
+    const std::chrono::microseconds step{
+        1U << std::min(attempt - SpinLimit, max_sleep_shift)};
+    ++attempt;
+    if (const auto wake_at = Clock::now() + step; wake_at < deadline) {
+      std::this_thread::sleep_until(wake_at);
+    } else {
+      std::this_thread::sleep_until(deadline);
+    }
+  }
+
+  static void wake(std::atomic<size_t> &index,
+                   const std::atomic<bool> &parked) noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked.load(std::memory_order_relaxed)) {
+      index.notify_one();
+    }
+  }
+
+public:
+  using policy_kind = policy_kind::wait;
+  template <size_t Line> using padded = AtomicWait<SpinLimit, Line>;
+
+  static void pause(unsigned &attempt) noexcept {
+    SpinYieldWait<SpinLimit>::pause(attempt);
+  }
+
+  void wait_for_data(const std::atomic<size_t> &head, size_t observed,
+                     unsigned &attempt) noexcept {
+    if (attempt < SpinLimit) {
+      cpu_relax();
+      ++attempt;
+      return;
+    }
+    park(head, observed, _consumer_parked);
+  }
+
+  void wait_for_space(const std::atomic<size_t> &tail, size_t observed,
+                      unsigned &attempt) noexcept {
+    if (attempt < SpinLimit) {
+      cpu_relax();
+      ++attempt;
+      return;
+    }
+    park(tail, observed, _producer_parked);
+  }
+
+  template <typename Clock, typename Duration>
+  static void wait_for_data_until(
+      const std::atomic<size_t> & /*head*/, size_t /*observed*/,
+      unsigned &attempt,
+      const std::chrono::time_point<Clock, Duration> &deadline) {
+    sleep_until(attempt, deadline);
+  }
+
+  template <typename Clock, typename Duration>
+  static void wait_for_space_until(
+      const std::atomic<size_t> & /*tail*/, size_t /*observed*/,
+      unsigned &attempt,
+      const std::chrono::time_point<Clock, Duration> &deadline) {
+    sleep_until(attempt, deadline);
+  }
+
+  void notify_data(std::atomic<size_t> &head) noexcept {
+    wake(head, _consumer_parked);
+  }
+  void notify_space(std::atomic<size_t> &tail) noexcept {
+    wake(tail, _producer_parked);
+  }
+};
+
+} // namespace bring
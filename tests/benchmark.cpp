@@ -10,12 +10,12 @@ int main() {
   // Benchmark: Fill and drain the buffer repeatedly
   for (size_t iter = 0; iter < ITERATIONS; ++iter) {
     // Fill buffer
-    for (size_t i = 0; i < CAPACITY - 1; ++i) {
+    for (size_t i = 0; i < CAPACITY; ++i) {
       buffer.try_push(static_cast<int>(i));
     }
 
     // Drain buffer
-    for (size_t i = 0; i < CAPACITY - 1; ++i) {
+    for (size_t i = 0; i < CAPACITY; ++i) {
       static_cast<void>(buffer.try_pop());
     }
   }
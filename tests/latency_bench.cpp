@@ -0,0 +1,312 @@
+// Round-trip latency harness: a ping thread sends a message through one ring,
+// a pong thread echoes it back through another, and the ping thread records
+// every round trip into a log-linear histogram.
+//
+//   latency_bench [--iterations N] [--warmup N] [--size BYTES] [--batch N]
+//                 [--wait busy|yield|atomic] [--ring cached|baseline]
+//                 [--ping-cpu CPU] [--pong-cpu CPU] [--clock tsc|steady]
+#include "affinity.hpp"
+#include "baseline_ring_buffer.hpp"
+#include <bring/latency.hpp>
+#include <bring/ring_buffer.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-identifier-length,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+namespace {
+
+constexpr size_t CAPACITY = 1024;
+
+// Exact below 32, then within 2^-5 (about 3%) of the recorded value
+using RoundTripHistogram = bring::BasicLatencyHistogram<5>;
+
+enum class Clock { Ticks, Steady };
+
+uint64_t now_ticks(Clock clock) noexcept {
+  if (clock == Clock::Ticks) {
+    return bring::read_ticks();
+  }
+  return static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+// Ticks per nanosecond of the chosen clock
+double ticks_per_ns(Clock clock) {
+  if (clock == Clock::Steady) {
+    using period = std::chrono::steady_clock::period;
+    return static_cast<double>(period::den) / (period::num * 1e9);
+  }
+  return bring::measure_ticks_per_ns(std::chrono::milliseconds(200));
+}
+
+struct Options {
+  uint64_t iterations{1'000'000};
+  uint64_t warmup{100'000};
+  size_t size{64};
+  size_t batch{1};
+  std::string wait{"busy"};
+  std::string ring{"cached"};
+  std::optional<int> ping_cpu;
+  std::optional<int> pong_cpu;
+  Clock clock{Clock::Ticks};
+};
+
+[[noreturn]] void usage(const char *message) {
+  std::fprintf(stderr,
+               "error: %s\n"
+               "usage: latency_bench [--iterations N] [--warmup N] "
+               "[--size 8|16|32|64|128|256]\n"
+               "                     [--batch N] [--wait busy|yield|atomic] "
+               "[--ring cached|baseline]\n"
+               "                     [--ping-cpu CPU] [--pong-cpu CPU] "
+               "[--clock tsc|steady]\n",
+               message);
+  std::exit(2);
+}
+
+Options parse_options(std::span<char *> args) {
+  Options options;
+  for (size_t i = 1; i < args.size(); ++i) {
+    const std::string_view flag = args[i];
+    if (i + 1 >= args.size()) {
+      usage("missing value for flag");
+    }
+    const std::string value = args[++i];
+    if (flag == "--iterations") {
+      options.iterations = std::stoull(value);
+    } else if (flag == "--warmup") {
+      options.warmup = std::stoull(value);
+    } else if (flag == "--size") {
+      options.size = std::stoul(value);
+    } else if (flag == "--batch") {
+      options.batch = std::stoul(value);
+    } else if (flag == "--wait") {
+      options.wait = value;
+    } else if (flag == "--ring") {
+      options.ring = value;
+    } else if (flag == "--ping-cpu") {
+      options.ping_cpu = std::stoi(value);
+    } else if (flag == "--pong-cpu") {
+      options.pong_cpu = std::stoi(value);
+    } else if (flag == "--clock") {
+      if (value == "steady") {
+        options.clock = Clock::Steady;
+      } else if (value == "tsc") {
+        options.clock = Clock::Ticks;
+      } else {
+        usage("unknown clock");
+      }
+    } else {
+      usage("unknown flag");
+    }
+  }
+  if (options.batch == 0 || options.batch > CAPACITY) {
+    usage("--batch must be between 1 and the ring capacity");
+  }
+  if (options.ring == "baseline" &&
+      (options.batch != 1 || options.wait != "busy")) {
+    usage("the baseline ring only supports --batch 1 --wait busy");
+  }
+  return options;
+}
+
+// Message of Bytes bytes whose first word carries a sequence number, so the
+// pong side has something real to echo and ping can check it
+template <size_t Bytes> struct Message {
+  static_assert(Bytes >= sizeof(uint64_t));
+  std::array<std::byte, Bytes> bytes{};
+
+  void set_sequence(uint64_t sequence) noexcept {
+    std::memcpy(bytes.data(), &sequence, sizeof(sequence));
+  }
+  [[nodiscard]] uint64_t sequence() const noexcept {
+    uint64_t sequence = 0;
+    std::memcpy(&sequence, bytes.data(), sizeof(sequence));
+    return sequence;
+  }
+};
+
+// Pushes every message of `batch`, waiting for space as needed. The baseline
+// ring has no blocking or bulk operations, so it spins on one message
+template <typename Ring, typename Msg>
+void send_batch(Ring &out, std::span<const Msg> batch) {
+  if constexpr (requires { out.try_push_n(batch); }) {
+    size_t sent = 0;
+    unsigned attempt = 0;
+    while (sent < batch.size()) {
+      const size_t pushed = out.try_push_n(batch.subspan(sent));
+      sent += pushed;
+      if (pushed == 0) {
+        Ring::wait_strategy::pause(attempt);
+      }
+    }
+  } else {
+    while (!out.try_push(batch[0])) {
+      bring::cpu_relax();
+    }
+  }
+}
+
+// Fills `batch` with the next messages from `in`, waiting for them to arrive
+template <typename Ring, typename Msg>
+void receive_batch(Ring &in, std::span<Msg> batch) {
+  if constexpr (requires { in.pop_wait(); }) {
+    // Block the way the wait strategy says for the first message, then take
+    // the rest of the batch in bulk
+    batch[0] = in.pop_wait();
+    size_t received = 1;
+    unsigned attempt = 0;
+    while (received < batch.size()) {
+      const size_t popped = in.try_pop_n(batch.subspan(received));
+      received += popped;
+      if (popped == 0) {
+        Ring::wait_strategy::pause(attempt);
+      }
+    }
+  } else {
+    std::optional<Msg> value;
+    while (!(value = in.try_pop())) {
+      bring::cpu_relax();
+    }
+    batch[0] = *value;
+  }
+}
+
+void pin_or_die(std::optional<int> cpu, const char *who) {
+  if (cpu && !bring_bench::pin_current_thread(*cpu)) {
+    std::fprintf(stderr, "error: could not pin %s thread to CPU %d\n", who,
+                 *cpu);
+    std::exit(1);
+  }
+}
+
+template <typename Ring, typename Msg> int run(const Options &options) {
+  auto ping = std::make_unique<Ring>();
+  auto pong = std::make_unique<Ring>();
+  const uint64_t rounds = options.warmup + options.iterations;
+
+  std::thread echo([&]() {
+    pin_or_die(options.pong_cpu, "pong");
+    std::vector<Msg> batch(options.batch);
+    for (uint64_t r = 0; r < rounds; ++r) {
+      receive_batch<Ring, Msg>(*ping, batch);
+      send_batch<Ring, Msg>(*pong, batch);
+    }
+  });
+
+  pin_or_die(options.ping_cpu, "ping");
+  const double tick_rate = ticks_per_ns(options.clock);
+  RoundTripHistogram histogram;
+  std::vector<Msg> outgoing(options.batch);
+  std::vector<Msg> incoming(options.batch);
+  bool in_order = true;
+
+  for (uint64_t r = 0; r < rounds; ++r) {
+    for (size_t i = 0; i < outgoing.size(); ++i) {
+      outgoing[i].set_sequence((r * options.batch) + i);
+    }
+    const uint64_t start = now_ticks(options.clock);
+    send_batch<Ring, Msg>(*ping, outgoing);
+    receive_batch<Ring, Msg>(*pong, incoming);
+    const uint64_t stop = now_ticks(options.clock);
+
+    in_order = in_order && incoming.back().sequence() ==
+                               outgoing.back().sequence();
+    if (r >= options.warmup) {
+      histogram.record(static_cast<uint64_t>(
+          static_cast<double>(stop - start) / tick_rate));
+    }
+  }
+  echo.join();
+
+  if (!in_order) {
+    std::fprintf(stderr, "error: messages came back out of order\n");
+    return 1;
+  }
+
+  std::printf("ring=%s wait=%s size=%zu batch=%zu iterations=%llu "
+              "warmup=%llu clock=%s ping_cpu=%d pong_cpu=%d\n",
+              options.ring.c_str(), options.wait.c_str(), options.size,
+              options.batch,
+              static_cast<unsigned long long>(options.iterations),
+              static_cast<unsigned long long>(options.warmup),
+              options.clock == Clock::Ticks ? "tsc" : "steady",
+              options.ping_cpu.value_or(-1), options.pong_cpu.value_or(-1));
+  std::printf("round trip ns: p50=%llu p90=%llu p99=%llu p99.9=%llu "
+              "p99.99=%llu max=%llu\n",
+              static_cast<unsigned long long>(histogram.percentile(0.50)),
+              static_cast<unsigned long long>(histogram.percentile(0.90)),
+              static_cast<unsigned long long>(histogram.percentile(0.99)),
+              static_cast<unsigned long long>(histogram.percentile(0.999)),
+              static_cast<unsigned long long>(histogram.percentile(0.9999)),
+              static_cast<unsigned long long>(histogram.max()));
+  return 0;
+}
+
+template <typename Msg> int dispatch_ring(const Options &options) {
+  if (options.ring == "baseline") {
+    return run<bring_bench::BaselineRingBuffer<Msg, CAPACITY>, Msg>(options);
+  }
+  if (options.ring != "cached") {
+    usage("unknown ring");
+  }
+  if (options.wait == "busy") {
+    return run<bring::RingBuffer<Msg, CAPACITY, bring::BusySpinWait>, Msg>(
+        options);
+  }
+  if (options.wait == "yield") {
+    return run<bring::RingBuffer<Msg, CAPACITY, bring::SpinYieldWait<>>, Msg>(
+        options);
+  }
+  if (options.wait == "atomic") {
+    return run<bring::RingBuffer<Msg, CAPACITY, bring::AtomicWait<>>, Msg>(
+        options);
+  }
+  usage("unknown wait strategy");
+}
+
+int dispatch_size(const Options &options) {
+  switch (options.size) {
+  case 8:
+    return dispatch_ring<Message<8>>(options);
+  case 16:
+    return dispatch_ring<Message<16>>(options);
+  case 32:
+    return dispatch_ring<Message<32>>(options);
+  case 64:
+    return dispatch_ring<Message<64>>(options);
+  case 128:
+    return dispatch_ring<Message<128>>(options);
+  case 256:
+    return dispatch_ring<Message<256>>(options);
+  default:
+    usage("unsupported message size");
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  try {
+    options = parse_options(std::span<char *>(argv, static_cast<size_t>(argc)));
+  } catch (const std::exception &) {
+    usage("invalid number");
+  }
+  return dispatch_size(options);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,readability-identifier-length,cppcoreguidelines-pro-bounds-pointer-arithmetic)
@@ -1,8 +1,46 @@
+#include <bring/broadcast_ring_buffer.hpp>
+#include <bring/byte_ring_buffer.hpp>
+#include <bring/latency.hpp>
+#include <bring/mpmc_ring_buffer.hpp>
+#include <bring/mpsc_ring_buffer.hpp>
+#include <bring/overwrite_ring_buffer.hpp>
+#include <bring/pool_channel.hpp>
+#include <bring/priority_ring_buffer.hpp>
 #include <bring/ring_buffer.hpp>
+#include <bring/ring_set.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <bring/memory_resource.hpp>
+#include <bring/shm_ring_buffer.hpp>
+#include <system_error>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <bring/eventfd_wait.hpp>
+#include <poll.h>
+#endif
+
 // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,bugprone-chained-comparison,readability-identifier-length,bugprone-unchecked-optional-access,bugprone-use-after-move,readability-function-cognitive-complexity,readability-identifier-naming)
 
 TEST_CASE("RingBuffer basic construction", "[ring_buffer]") {
@@ -29,13 +67,15 @@ TEST_CASE("RingBuffer is_empty and is_full", "[ring_buffer]") {
   }
 
   SECTION("Buffer is full at capacity") {
-    // Capacity is 4, but we can only store 3 elements (one slot reserved)
+    // Capacity is 4 and all 4 slots are usable
     REQUIRE(buffer.try_push(1));
     REQUIRE(buffer.try_push(2));
     REQUIRE(buffer.try_push(3));
+    REQUIRE_FALSE(buffer.is_full());
+    REQUIRE(buffer.try_push(4));
     REQUIRE(buffer.is_full());
     REQUIRE_FALSE(buffer.is_empty());
-    REQUIRE_FALSE(buffer.try_push(4)); // Confirm it's actually full
+    REQUIRE_FALSE(buffer.try_push(5)); // Confirm it's actually full
   }
 
   SECTION("Buffer becomes empty after popping all") {
@@ -55,6 +95,7 @@ TEST_CASE("RingBuffer is_empty and is_full", "[ring_buffer]") {
     REQUIRE(buffer.try_push(1));
     REQUIRE(buffer.try_push(2));
     REQUIRE(buffer.try_push(3));
+    REQUIRE(buffer.try_push(4));
     REQUIRE(buffer.is_full());
 
     // Pop one
@@ -63,13 +104,14 @@ TEST_CASE("RingBuffer is_empty and is_full", "[ring_buffer]") {
     REQUIRE_FALSE(buffer.is_empty());
 
     // Fill again
-    REQUIRE(buffer.try_push(4));
+    REQUIRE(buffer.try_push(5));
     REQUIRE(buffer.is_full());
 
     // Drain completely
     static_cast<void>(buffer.try_pop());
     static_cast<void>(buffer.try_pop());
     static_cast<void>(buffer.try_pop());
+    static_cast<void>(buffer.try_pop());
     REQUIRE(buffer.is_empty());
     REQUIRE_FALSE(buffer.is_full());
   }
@@ -110,21 +152,49 @@ TEST_CASE("RingBuffer capacity handling", "[ring_buffer]") {
   bring::RingBuffer<int, 4> buffer;
 
   SECTION("Fill buffer to capacity") {
-    // Capacity is 4, but we can only store 3 elements (one slot reserved)
+    // Capacity is 4 and all 4 slots are usable
     REQUIRE(buffer.try_push(1));
     REQUIRE(buffer.try_push(2));
     REQUIRE(buffer.try_push(3));
-    REQUIRE_FALSE(buffer.try_push(4)); // Buffer full
+    REQUIRE(buffer.try_push(4));
+    REQUIRE_FALSE(buffer.try_push(5)); // Buffer full
   }
 
   SECTION("Can push after popping from full buffer") {
     REQUIRE(buffer.try_push(1));
     REQUIRE(buffer.try_push(2));
     REQUIRE(buffer.try_push(3));
-    REQUIRE_FALSE(buffer.try_push(4)); // Full
+    REQUIRE(buffer.try_push(4));
+    REQUIRE_FALSE(buffer.try_push(5)); // Full
 
     static_cast<void>(buffer.try_pop()); // Remove one element
-    REQUIRE(buffer.try_push(4)); // Now we can push
+    REQUIRE(buffer.try_push(5)); // Now we can push
+  }
+
+  SECTION("size and free_space track occupancy") {
+    REQUIRE(buffer.size() == 0);
+    REQUIRE(buffer.free_space() == 4);
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_push(2));
+    REQUIRE(buffer.size() == 2);
+    REQUIRE(buffer.free_space() == 2);
+    static_cast<void>(buffer.try_pop());
+    REQUIRE(buffer.size() == 1);
+    REQUIRE(buffer.free_space() == 3);
+  }
+
+  SECTION("get_state and approx_size agree with size") {
+    auto state = buffer.get_state();
+    REQUIRE((state.empty && !state.full && state.size == 0));
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    state = buffer.get_state();
+    REQUIRE((!state.empty && state.full && state.size == 4));
+    REQUIRE(buffer.approx_size() == 4);
+    const auto &observer = buffer;
+    REQUIRE(observer.is_full());
+    REQUIRE_FALSE(observer.is_empty());
   }
 }
 
@@ -256,7 +326,8 @@ TEST_CASE("RingBuffer emplace", "[ring_buffer]") {
     REQUIRE(buffer.emplace("5"));
     REQUIRE(buffer.emplace("6"));
     REQUIRE(buffer.emplace("7"));
-    REQUIRE_FALSE(buffer.emplace("8")); // Full
+    REQUIRE(buffer.emplace("8"));
+    REQUIRE_FALSE(buffer.emplace("9")); // Full
   }
 }
 
@@ -335,6 +406,31 @@ TEST_CASE("RingBuffer destructor cleanup", "[ring_buffer]") {
     }
     REQUIRE(destructor_count == 3);
   }
+
+  SECTION("Pushes DeferredPublish has not published are destroyed too") {
+    using Ring = bring::RingBuffer<std::shared_ptr<int>, 8,
+                                   bring::DeferredPublish<4>>;
+    const auto shared = std::make_shared<int>(7);
+    {
+      Ring ring;
+      REQUIRE(ring.try_push(shared));
+      REQUIRE(ring.try_push(shared));
+      REQUIRE(ring.size() == 0);
+      REQUIRE(shared.use_count() == 3);
+    }
+    REQUIRE(shared.use_count() == 1);
+
+    Ring target;
+    REQUIRE(target.try_push(shared));
+    REQUIRE(target.try_push(shared));
+    // One element popped but its slot not handed back yet: it is gone
+    // already and must not be destroyed again
+    target.publish();
+    REQUIRE(target.try_pop().has_value());
+    REQUIRE(shared.use_count() == 2);
+    target = Ring();
+    REQUIRE(shared.use_count() == 1);
+  }
 }
 
 TEST_CASE("RingBuffer stress test", "[ring_buffer]") {
@@ -414,4 +510,1882 @@ TEST_CASE("RingBuffer move semantics", "[ring_buffer]") {
   }
 }
 
+TEST_CASE("RingBuffer bulk push and pop", "[ring_buffer][bulk]") {
+  bring::RingBuffer<int, 8> buffer;
+
+  SECTION("try_push_n from a span pushes everything that fits") {
+    std::vector<int> items(10);
+    std::iota(items.begin(), items.end(), 0);
+    REQUIRE(buffer.try_push_n(std::span<const int>(items)) == 8);
+    REQUIRE(buffer.is_full());
+    REQUIRE(buffer.try_push_n(std::span<const int>(items)) == 0);
+
+    std::vector<int> out(10, -1);
+    REQUIRE(buffer.try_pop_n(std::span<int>(out)) == 8);
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(out[static_cast<size_t>(i)] == i);
+    }
+    REQUIRE(out[8] == -1);
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Bulk operations wrap around as two segments") {
+    const std::vector<int> first{1, 2, 3, 4, 5};
+    REQUIRE(buffer.try_push_n(std::span<const int>(first)) == 5);
+    std::vector<int> out(4);
+    REQUIRE(buffer.try_pop_n(std::span<int>(out)) == 4);
+    REQUIRE(out == std::vector{1, 2, 3, 4});
+
+    // head is at 5, so this batch spans slots 5..7 and 0..3
+    const std::vector<int> batch{6, 7, 8, 9, 10, 11, 12};
+    REQUIRE(buffer.try_push_n(std::span<const int>(batch)) == 7);
+    REQUIRE(buffer.is_full());
+
+    std::vector<int> rest(8);
+    REQUIRE(buffer.try_pop_n(std::span<int>(rest)) == 8);
+    REQUIRE(rest == std::vector{5, 6, 7, 8, 9, 10, 11, 12});
+  }
+
+  SECTION("try_push_n accepts non-sized iterator ranges") {
+    const std::list<int> items{1, 2, 3};
+    REQUIRE(buffer.try_push_n(items.begin(), items.end()) == 3);
+    REQUIRE(buffer.try_pop().value() == 1);
+    REQUIRE(buffer.try_pop().value() == 2);
+    REQUIRE(buffer.try_pop().value() == 3);
+  }
+
+  SECTION("try_pop_n on an empty buffer transfers nothing") {
+    std::vector<int> out(4);
+    REQUIRE(buffer.try_pop_n(std::span<int>(out)) == 0);
+  }
+}
+
+TEST_CASE("RingBuffer consume_n", "[ring_buffer][bulk]") {
+  bring::RingBuffer<std::string, 8> buffer;
+  for (int i = 0; i < 6; ++i) {
+    REQUIRE(buffer.emplace(std::to_string(i)));
+  }
+
+  SECTION("Consumes at most max elements in order") {
+    std::vector<std::string> seen;
+    REQUIRE(buffer.consume_n(4, [&](std::string &&value) {
+      seen.push_back(std::move(value));
+    }) == 4);
+    REQUIRE(seen == std::vector<std::string>{"0", "1", "2", "3"});
+    REQUIRE(buffer.try_pop().value() == "4");
+  }
+
+  SECTION("Stops at the number of available elements") {
+    size_t calls = 0;
+    REQUIRE(buffer.consume_n(100, [&](std::string && /*value*/) {
+      ++calls;
+    }) == 6);
+    REQUIRE(calls == 6);
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("A throwing processor keeps the failed element") {
+    size_t calls = 0;
+    REQUIRE_THROWS(buffer.consume_n(6, [&](std::string &&value) {
+      if (value == "2") {
+        throw std::runtime_error("boom");
+      }
+      ++calls;
+    }));
+    REQUIRE(calls == 2);
+    REQUIRE(buffer.try_pop().value() == "2");
+  }
+}
+
+TEST_CASE("RingBuffer consume_all and consume_up_to", "[ring_buffer][bulk]") {
+  bring::RingBuffer<std::string, 8> buffer;
+  // Start at offset 5 so the ready elements wrap around the end
+  for (int i = 0; i < 5; ++i) {
+    REQUIRE(buffer.emplace("x"));
+    REQUIRE(buffer.try_pop());
+  }
+  for (int i = 0; i < 7; ++i) {
+    REQUIRE(buffer.emplace(std::to_string(i)));
+  }
+
+  SECTION("consume_all drains every ready element in order") {
+    std::vector<std::string> seen;
+    REQUIRE(buffer.consume_all([&](std::string &&value) {
+      seen.push_back(std::move(value));
+    }) == 7);
+    REQUIRE(seen ==
+            std::vector<std::string>{"0", "1", "2", "3", "4", "5", "6"});
+    REQUIRE(buffer.is_empty());
+    REQUIRE(buffer.consume_all([](std::string && /*value*/) {}) == 0);
+  }
+
+  SECTION("consume_up_to stops at max") {
+    std::vector<std::string> seen;
+    REQUIRE(buffer.consume_up_to<1>(3, [&](std::string &&value) {
+      seen.push_back(std::move(value));
+    }) == 3);
+    REQUIRE(seen == std::vector<std::string>{"0", "1", "2"});
+    REQUIRE(buffer.size() == 4);
+  }
+
+  SECTION("PublishEvery releases slots during the burst") {
+    std::vector<size_t> sizes;
+    REQUIRE(buffer.consume_all<0, 2>([&](std::string && /*value*/) {
+      sizes.push_back(buffer.size());
+    }) == 7);
+    REQUIRE(sizes == std::vector<size_t>{7, 7, 5, 5, 3, 3, 1});
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Without PublishEvery the tail moves once at the end") {
+    std::vector<size_t> sizes;
+    buffer.consume_all([&](std::string && /*value*/) {
+      sizes.push_back(buffer.size());
+    });
+    REQUIRE(sizes == std::vector<size_t>(7, 7));
+  }
+
+  SECTION("A throwing processor publishes the elements before it") {
+    size_t calls = 0;
+    REQUIRE_THROWS(buffer.consume_all<2, 2>([&](std::string &&value) {
+      if (value == "3") {
+        throw std::runtime_error("boom");
+      }
+      ++calls;
+    }));
+    REQUIRE(calls == 3);
+    REQUIRE(buffer.size() == 4);
+    REQUIRE(buffer.try_pop().value() == "3");
+  }
+}
+
+TEST_CASE("RingBuffer reserve and commit", "[ring_buffer][zero_copy]") {
+  bring::RingBuffer<std::string, 8> buffer;
+
+  SECTION("Reserved slots are invisible until committed") {
+    auto slots = buffer.reserve(3);
+    REQUIRE(slots.size() == 3);
+    std::construct_at(&slots[0], "a");
+    std::construct_at(&slots[1], "b");
+    REQUIRE(buffer.is_empty());
+
+    buffer.commit(2);
+    REQUIRE(buffer.try_pop().value() == "a");
+    REQUIRE(buffer.try_pop().value() == "b");
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Reserve is limited by free space") {
+    auto slots = buffer.reserve(100);
+    REQUIRE(slots.size() == 8);
+    for (size_t i = 0; i < slots.size(); ++i) {
+      std::construct_at(&slots[i], std::to_string(i));
+    }
+    buffer.commit(slots.size());
+    REQUIRE(buffer.is_full());
+    REQUIRE(buffer.reserve(1).empty());
+  }
+
+  SECTION("Reserve stops at the wrap point") {
+    for (int i = 0; i < 6; ++i) {
+      REQUIRE(buffer.emplace("x"));
+    }
+    for (int i = 0; i < 6; ++i) {
+      static_cast<void>(buffer.try_pop());
+    }
+    // head is at slot 6: two slots before the end of storage
+    auto first = buffer.reserve(5);
+    REQUIRE(first.size() == 2);
+    std::construct_at(&first[0], "6");
+    std::construct_at(&first[1], "7");
+    buffer.commit(2);
+
+    auto second = buffer.reserve(5);
+    REQUIRE(second.size() == 5);
+    std::construct_at(&second[0], "8");
+    buffer.commit(1);
+
+    REQUIRE(buffer.try_pop().value() == "6");
+    REQUIRE(buffer.try_pop().value() == "7");
+    REQUIRE(buffer.try_pop().value() == "8");
+    REQUIRE(buffer.is_empty());
+  }
+}
+
+TEST_CASE("RingBuffer peek and release", "[ring_buffer][zero_copy]") {
+  static int destructor_count = 0;
+
+  struct Tracked {
+    int value;
+    explicit Tracked(int v) : value(v) {}
+    ~Tracked() { destructor_count++; }
+    Tracked(const Tracked &) = default;
+    Tracked(Tracked &&) noexcept = default;
+    Tracked &operator=(const Tracked &) = default;
+    Tracked &operator=(Tracked &&) noexcept = default;
+  };
+
+  destructor_count = 0;
+  bring::RingBuffer<Tracked, 8> buffer;
+
+  SECTION("Peek on an empty buffer is empty") {
+    REQUIRE(buffer.peek(4).empty());
+  }
+
+  SECTION("Peek exposes elements in place and release destroys them") {
+    REQUIRE(buffer.emplace(1));
+    REQUIRE(buffer.emplace(2));
+    REQUIRE(buffer.emplace(3));
+
+    auto ready = buffer.peek(8);
+    REQUIRE(ready.size() == 3);
+    REQUIRE(ready[0].value == 1);
+    REQUIRE(ready[2].value == 3);
+
+    // Peeking again without release sees the same elements
+    REQUIRE(buffer.peek(8).data() == ready.data());
+
+    buffer.release(2);
+    REQUIRE(destructor_count == 2);
+    auto rest = buffer.peek(8);
+    REQUIRE(rest.size() == 1);
+    REQUIRE(rest[0].value == 3);
+    buffer.release(1);
+    REQUIRE(buffer.is_empty());
+  }
+}
+
+TEST_CASE("DynamicRingBuffer construction", "[dynamic_ring_buffer]") {
+  SECTION("Capacity is taken from the constructor") {
+    bring::DynamicRingBuffer<int> buffer(16);
+    REQUIRE(buffer.capacity() == 16);
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Rejects capacities that are not a power of two") {
+    REQUIRE_THROWS_AS(bring::DynamicRingBuffer<int>(12), std::invalid_argument);
+    REQUIRE_THROWS_AS(bring::DynamicRingBuffer<int>(1), std::invalid_argument);
+    REQUIRE_THROWS_AS(bring::DynamicRingBuffer<int>(0), std::invalid_argument);
+  }
+}
+
+TEST_CASE("DynamicRingBuffer operations", "[dynamic_ring_buffer]") {
+  bring::DynamicRingBuffer<std::string> buffer(4);
+
+  SECTION("Fills to capacity and wraps around") {
+    REQUIRE(buffer.try_push(std::string("a")));
+    REQUIRE(buffer.emplace("b"));
+    REQUIRE(buffer.emplace("c"));
+    REQUIRE(buffer.emplace("d"));
+    REQUIRE(buffer.is_full());
+    REQUIRE_FALSE(buffer.try_push(std::string("e")));
+
+    REQUIRE(buffer.try_pop().value() == "a");
+    REQUIRE(buffer.try_pop().value() == "b");
+    REQUIRE(buffer.emplace("e"));
+    REQUIRE(buffer.emplace("f"));
+
+    std::vector<std::string> out(5);
+    REQUIRE(buffer.try_pop_n(std::span<std::string>(out)) == 4);
+    REQUIRE(out[0] == "c");
+    REQUIRE(out[1] == "d");
+    REQUIRE(out[2] == "e");
+    REQUIRE(out[3] == "f");
+  }
+
+  SECTION("Move keeps capacity and contents") {
+    REQUIRE(buffer.emplace("x"));
+    bring::DynamicRingBuffer<std::string> other(64);
+    other = std::move(buffer);
+    REQUIRE(other.capacity() == 4);
+    REQUIRE(other.try_pop().value() == "x");
+
+    bring::DynamicRingBuffer<std::string> moved(std::move(other));
+    REQUIRE(moved.capacity() == 4);
+    REQUIRE(moved.is_empty());
+  }
+}
+
+TEST_CASE("RingBuffer capacity", "[ring_buffer]") {
+  const bring::RingBuffer<int, 32> buffer;
+  REQUIRE(buffer.capacity() == 32);
+  STATIC_REQUIRE(bring::StaticCapacity<32>::mask() == 31);
+}
+
+TEST_CASE("RingBuffer full capacity across many laps", "[ring_buffer]") {
+  bring::RingBuffer<int, 4> buffer;
+
+  // Every lap fills all slots and drains them, so head and tail keep growing
+  // past the capacity while only the masked index is used for storage
+  for (int lap = 0; lap < 100; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_push((lap * 4) + i));
+    }
+    REQUIRE(buffer.is_full());
+    REQUIRE(buffer.size() == 4);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_pop().value() == (lap * 4) + i);
+    }
+    REQUIRE(buffer.is_empty());
+  }
+}
+
+TEST_CASE("RingBuffer wait strategy selection", "[ring_buffer][wait]") {
+  STATIC_REQUIRE(std::is_same_v<bring::RingBuffer<int, 8>::wait_strategy,
+                                bring::BusySpinWait>);
+  STATIC_REQUIRE(
+      std::is_same_v<bring::RingBuffer<int, 8, bring::AtomicWait<>>::wait_strategy,
+                     bring::AtomicWait<>>);
+  STATIC_REQUIRE(
+      std::is_same_v<bring::DynamicRingBuffer<int, bring::SpinYieldWait<8>>::wait_strategy,
+                     bring::SpinYieldWait<8>>);
+}
+
+TEST_CASE("RingBuffer blocking operations", "[ring_buffer][wait]") {
+  using namespace std::chrono_literals;
+  bring::RingBuffer<int, 2, bring::AtomicWait<>> buffer;
+
+  SECTION("pop_wait returns immediately when data is available") {
+    REQUIRE(buffer.try_push(7));
+    REQUIRE(buffer.pop_wait() == 7);
+  }
+
+  SECTION("push_wait returns immediately when space is available") {
+    buffer.push_wait(1);
+    buffer.push_wait(2);
+    REQUIRE(buffer.is_full());
+  }
+
+  SECTION("pop_wait_for times out on an empty buffer") {
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(buffer.pop_wait_for(5ms).has_value());
+    REQUIRE(std::chrono::steady_clock::now() - start >= 5ms);
+  }
+
+  SECTION("push_wait_for times out on a full buffer") {
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_push(2));
+    REQUIRE_FALSE(buffer.push_wait_for(3, 5ms));
+    REQUIRE(buffer.try_pop().value() == 1);
+    REQUIRE(buffer.push_wait_for(3, 5ms));
+  }
+
+  SECTION("pop_wait_until succeeds before the deadline") {
+    REQUIRE(buffer.try_push(9));
+    const auto deadline = std::chrono::steady_clock::now() + 1s;
+    REQUIRE(buffer.pop_wait_until(deadline).value() == 9);
+  }
+
+  SECTION("Timed waits sleep instead of spinning") {
+    const std::clock_t cpu_start = std::clock();
+    REQUIRE_FALSE(buffer.pop_wait_for(50ms).has_value());
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_push(2));
+    REQUIRE_FALSE(buffer.push_wait_for(3, 50ms));
+    const double cpu_seconds =
+        static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    REQUIRE(cpu_seconds < 0.05);
+  }
+}
+
+namespace {
+// Its move may throw and empties the source, so a test can tell whether a
+// push that failed moved from its argument
+struct StealingMove {
+  std::string text;
+  explicit StealingMove(std::string value) : text(std::move(value)) {}
+  StealingMove(const StealingMove &) = default;
+  // NOLINTNEXTLINE(performance-noexcept-move-constructor)
+  StealingMove(StealingMove &&other) noexcept(false)
+      : text(std::move(other.text)) {}
+  StealingMove &operator=(const StealingMove &) = default;
+  // NOLINTNEXTLINE(performance-noexcept-move-constructor)
+  StealingMove &operator=(StealingMove &&) noexcept(false) = default;
+  ~StealingMove() = default;
+};
+} // namespace
+
+TEST_CASE("MpscRingBuffer single-threaded operations", "[mpsc]") {
+  bring::MpscRingBuffer<int, 4> buffer;
+  STATIC_REQUIRE(decltype(buffer)::capacity() == 4);
+
+  SECTION("Newly created buffer is empty") {
+    REQUIRE(buffer.is_empty());
+    REQUIRE(buffer.size() == 0);
+    REQUIRE_FALSE(buffer.try_pop().has_value());
+  }
+
+  SECTION("Every slot is usable and order is FIFO") {
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    REQUIRE(buffer.is_full());
+    REQUIRE_FALSE(buffer.try_push(99));
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_pop().value() == i);
+    }
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Slots are reused across many laps") {
+    for (int i = 0; i < 1000; ++i) {
+      REQUIRE(buffer.try_push(i));
+      REQUIRE(buffer.try_push(-i));
+      int out = 0;
+      REQUIRE(buffer.try_pop_ip(out));
+      REQUIRE(out == i);
+      REQUIRE(buffer.try_consume([i](int &&v) { REQUIRE(v == -i); }));
+    }
+    REQUIRE(buffer.is_empty());
+  }
+}
+
+TEST_CASE("MpscRingBuffer element lifetime", "[mpsc]") {
+  SECTION("Move-only types and emplace") {
+    bring::MpscRingBuffer<std::unique_ptr<int>, 2> buffer;
+    REQUIRE(buffer.emplace(std::make_unique<int>(5)));
+    REQUIRE(*buffer.try_pop().value() == 5);
+  }
+
+  SECTION("Destructor releases remaining elements") {
+    auto tracker = std::make_shared<int>(0);
+    {
+      bring::MpscRingBuffer<std::shared_ptr<int>, 4> buffer;
+      REQUIRE(buffer.try_push(tracker));
+      REQUIRE(buffer.try_push(tracker));
+      REQUIRE(tracker.use_count() == 3);
+    }
+    REQUIRE(tracker.use_count() == 1);
+  }
+
+  SECTION("Throwing constructor leaves the ring usable") {
+    struct Picky {
+      int value;
+      explicit Picky(int v) : value(v) {
+        if (v < 0) {
+          throw std::runtime_error("negative");
+        }
+      }
+    };
+    bring::MpscRingBuffer<Picky, 2> buffer;
+    REQUIRE_THROWS_AS(buffer.emplace(-1), std::runtime_error);
+    REQUIRE(buffer.is_empty());
+    REQUIRE(buffer.emplace(3));
+    REQUIRE(buffer.try_pop().value().value == 3);
+  }
+
+  SECTION("A push into a full ring leaves its rvalue alone") {
+    STATIC_REQUIRE_FALSE(std::is_nothrow_move_constructible_v<StealingMove>);
+    bring::MpscRingBuffer<StealingMove, 2> buffer;
+    REQUIRE(buffer.try_push(StealingMove("a")));
+    REQUIRE(buffer.try_push(StealingMove("b")));
+    StealingMove item("c");
+    REQUIRE_FALSE(buffer.try_push(std::move(item)));
+    // NOLINTNEXTLINE(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+    REQUIRE(item.text == "c");
+    REQUIRE(buffer.try_pop().value().text == "a");
+    // NOLINTNEXTLINE(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+    REQUIRE(buffer.try_push(std::move(item)));
+    REQUIRE(buffer.try_pop().value().text == "b");
+    REQUIRE(buffer.try_pop().value().text == "c");
+  }
+}
+
+TEST_CASE("MpmcRingBuffer single-threaded operations", "[mpmc]") {
+  bring::MpmcRingBuffer<int, 4> buffer;
+
+  SECTION("Every slot is usable and order is FIFO") {
+    REQUIRE(buffer.is_empty());
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    REQUIRE(buffer.is_full());
+    REQUIRE_FALSE(buffer.try_push(99));
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_pop().value() == i);
+    }
+    REQUIRE_FALSE(buffer.try_pop().has_value());
+  }
+
+  SECTION("Slots are reused across many laps") {
+    for (int i = 0; i < 1000; ++i) {
+      REQUIRE(buffer.emplace(i));
+      int out = -1;
+      REQUIRE(buffer.try_pop_ip(out));
+      REQUIRE(out == i);
+    }
+    REQUIRE(buffer.size() == 0);
+  }
+
+  SECTION("A throwing processor still releases the slot") {
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_push(2));
+    REQUIRE_THROWS_AS(
+        buffer.try_consume([](int &&) { throw std::runtime_error("boom"); }),
+        std::runtime_error);
+    REQUIRE(buffer.size() == 1);
+    REQUIRE(buffer.try_pop().value() == 2);
+  }
+
+  SECTION("Destructor releases remaining elements") {
+    auto tracker = std::make_shared<int>(0);
+    {
+      bring::MpmcRingBuffer<std::shared_ptr<int>, 2> shared;
+      REQUIRE(shared.try_push(tracker));
+      REQUIRE(tracker.use_count() == 2);
+    }
+    REQUIRE(tracker.use_count() == 1);
+  }
+
+  SECTION("A push into a full queue leaves its rvalue alone") {
+    bring::MpmcRingBuffer<StealingMove, 2> queue;
+    REQUIRE(queue.try_push(StealingMove("a")));
+    REQUIRE(queue.try_push(StealingMove("b")));
+    StealingMove item("c");
+    REQUIRE_FALSE(queue.try_push(std::move(item)));
+    // NOLINTNEXTLINE(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+    REQUIRE(item.text == "c");
+    REQUIRE(queue.try_pop().value().text == "a");
+    // NOLINTNEXTLINE(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+    REQUIRE(queue.try_push(std::move(item)));
+    REQUIRE(queue.try_pop().value().text == "b");
+    REQUIRE(queue.try_pop().value().text == "c");
+  }
+}
+
+TEST_CASE("BroadcastRingBuffer delivers every element to every reader", "[broadcast]") {
+  bring::BroadcastRingBuffer<int, 4, 2> buffer;
+  STATIC_REQUIRE(decltype(buffer)::readers() == 2);
+
+  SECTION("Readers consume independently") {
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_push(2));
+    REQUIRE(buffer.try_pop(0).value() == 1);
+    REQUIRE(buffer.try_pop(0).value() == 2);
+    REQUIRE(buffer.is_empty(0));
+    REQUIRE(buffer.size(1) == 2);
+    REQUIRE(buffer.try_pop(1).value() == 1);
+  }
+
+  SECTION("The producer gates on the slowest reader") {
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    REQUIRE(buffer.is_full());
+    // Reader 0 drained everything but reader 1 has not moved
+    REQUIRE(buffer.consume_n(0, 8, [](const int &) {}) == 4);
+    REQUIRE_FALSE(buffer.try_push(4));
+    REQUIRE(buffer.try_pop(1).value() == 0);
+    REQUIRE(buffer.try_push(4));
+    REQUIRE_FALSE(buffer.try_push(5));
+  }
+
+  SECTION("Readers see the same object without copies") {
+    REQUIRE(buffer.try_push(7));
+    const int *seen0 = nullptr;
+    const int *seen1 = nullptr;
+    REQUIRE(buffer.try_consume(0, [&](const int &v) { seen0 = &v; }));
+    REQUIRE(buffer.try_consume(1, [&](const int &v) { seen1 = &v; }));
+    REQUIRE(seen0 == seen1);
+  }
+
+  SECTION("consume_n keeps the finished part of a throwing batch") {
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    REQUIRE_THROWS_AS(buffer.consume_n(0, 3,
+                                       [](const int &v) {
+                                         if (v == 1) {
+                                           throw std::runtime_error("boom");
+                                         }
+                                       }),
+                      std::runtime_error);
+    REQUIRE(buffer.try_pop(0).value() == 1);
+  }
+}
+
+TEST_CASE("BroadcastRingBuffer element lifetime", "[broadcast]") {
+  auto tracker = std::make_shared<int>(0);
+  {
+    bring::BroadcastRingBuffer<std::shared_ptr<int>, 2, 2> buffer;
+    for (int lap = 0; lap < 10; ++lap) {
+      REQUIRE(buffer.try_push(tracker));
+      REQUIRE(buffer.try_consume(0, [](const std::shared_ptr<int> &) {}));
+      REQUIRE(buffer.try_consume(1, [](const std::shared_ptr<int> &) {}));
+    }
+    // Consumed elements are released once the producer reuses their slots,
+    // so at most a lap's worth stays alive
+    REQUIRE(tracker.use_count() <= 3);
+  }
+  REQUIRE(tracker.use_count() == 1);
+}
+
+namespace {
+template <typename Ring>
+concept HasStats = requires(const Ring &ring) { ring.stats(); };
+} // namespace
+
+TEST_CASE("RingBuffer stats policy", "[ring_buffer][stats]") {
+  SECTION("NoStats is the default and adds no state") {
+    STATIC_REQUIRE(std::same_as<bring::RingBuffer<int, 8>::stats_policy,
+                                bring::NoStats>);
+    STATIC_REQUIRE(sizeof(bring::RingBuffer<int, 8>) ==
+                   sizeof(bring::RingBuffer<int, 8, bring::NoStats>));
+    STATIC_REQUIRE_FALSE(HasStats<bring::RingBuffer<int, 8>>);
+    STATIC_REQUIRE(HasStats<bring::RingBuffer<int, 8, bring::RingStats>>);
+  }
+
+  SECTION("RingStats counts successes, failures and the high watermark") {
+    bring::RingBuffer<int, 4, bring::RingStats> buffer;
+    REQUIRE_FALSE(buffer.try_pop().has_value());
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    REQUIRE_FALSE(buffer.try_push(4));
+    REQUIRE_FALSE(buffer.emplace(5));
+    REQUIRE(buffer.try_pop().value() == 0);
+    int out = 0;
+    REQUIRE(buffer.try_pop_ip(out));
+
+    const bring::RingStatsSnapshot stats = buffer.stats();
+    REQUIRE(stats.pushes == 4);
+    REQUIRE(stats.pops == 2);
+    REQUIRE(stats.push_full == 2);
+    REQUIRE(stats.pop_empty == 1);
+    REQUIRE(stats.high_watermark == 4);
+  }
+
+  SECTION("Discarding elements on move assignment does not count pops") {
+    bring::RingBuffer<std::string, 4, bring::RingStats> buffer;
+    REQUIRE(buffer.try_push("a"));
+    REQUIRE(buffer.try_push("b"));
+    buffer = bring::RingBuffer<std::string, 4, bring::RingStats>();
+    REQUIRE(buffer.is_empty());
+    const bring::RingStatsSnapshot stats = buffer.stats();
+    REQUIRE(stats.pushes == 2);
+    REQUIRE(stats.pops == 0);
+    REQUIRE(stats.pop_empty == 0);
+  }
+
+  SECTION("Bulk and zero-copy operations count every element") {
+    bring::DynamicRingBuffer<int, bring::RingStats, bring::SpinYieldWait<>>
+        buffer(8);
+    const std::vector<int> in{1, 2, 3, 4, 5};
+    REQUIRE(buffer.try_push_n(std::span<const int>(in)) == 5);
+    auto slots = buffer.reserve(2);
+    REQUIRE(slots.size() == 2);
+    std::construct_at(&slots[0], 6);
+    std::construct_at(&slots[1], 7);
+    buffer.commit(2);
+
+    std::vector<int> out(3);
+    REQUIRE(buffer.try_pop_n(std::span<int>(out)) == 3);
+    REQUIRE(buffer.consume_n(2, [](int &&) {}) == 2);
+    const auto ready = buffer.peek(2);
+    REQUIRE(ready.size() == 2);
+    buffer.release(2);
+    REQUIRE(buffer.try_pop_n(std::span<int>(out)) == 0);
+
+    const auto stats = buffer.stats();
+    REQUIRE(stats.pushes == 7);
+    REQUIRE(stats.pops == 7);
+    REQUIRE(stats.push_full == 0);
+    REQUIRE(stats.pop_empty == 1);
+    REQUIRE(stats.high_watermark == 7);
+  }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("ShmRingBuffer create and attach", "[shm]") {
+  struct Tick {
+    uint64_t sequence;
+    double price;
+  };
+  using Ring = bring::ShmRingBuffer<Tick, 8>;
+  const std::string name = "/bring_unit_" + std::to_string(getpid());
+
+  SECTION("Both mappings see the same ring") {
+    Ring producer = Ring::create(name);
+    Ring consumer = Ring::attach(name);
+    REQUIRE(consumer.is_empty());
+
+    for (uint64_t i = 0; i < 8; ++i) {
+      REQUIRE(producer.try_push(Tick{i, 1.5 * static_cast<double>(i)}));
+    }
+    REQUIRE_FALSE(producer.try_push(Tick{99, 0.0}));
+    REQUIRE(consumer.is_full());
+
+    for (uint64_t i = 0; i < 8; ++i) {
+      const auto tick = consumer.try_pop();
+      REQUIRE(tick.has_value());
+      REQUIRE(tick->sequence == i);
+    }
+    REQUIRE_FALSE(consumer.try_pop().has_value());
+    REQUIRE(producer.try_push(Tick{8, 0.0}));
+  }
+
+  SECTION("create fails if the name is taken") {
+    const Ring owner = Ring::create(name);
+    REQUIRE_THROWS_AS(Ring::create(name), std::system_error);
+  }
+
+  SECTION("attach fails for a missing ring") {
+    REQUIRE_THROWS_AS(Ring::attach(name), std::system_error);
+  }
+
+  SECTION("attach rejects a different layout") {
+    const Ring owner = Ring::create(name);
+    REQUIRE_THROWS_AS((bring::ShmRingBuffer<Tick, 16>::attach(name)),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS((bring::ShmRingBuffer<uint64_t, 8>::attach(name)),
+                      std::runtime_error);
+  }
+
+  SECTION("The creator unlinks the name, also after a move") {
+    {
+      Ring owner = Ring::create(name);
+      Ring moved = std::move(owner);
+      REQUIRE(moved.name() == name);
+    }
+    REQUIRE_THROWS_AS(Ring::attach(name), std::system_error);
+  }
+}
+#endif
+
+namespace {
+// Forwards to the default resource and records what the ring asked for
+class CountingResource : public std::pmr::memory_resource {
+public:
+  size_t allocations{0};
+  size_t deallocations{0};
+  size_t last_bytes{0};
+  size_t last_alignment{0};
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    last_bytes = bytes;
+    last_alignment = alignment;
+    return std::pmr::get_default_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+    ++deallocations;
+    std::pmr::get_default_resource()->deallocate(ptr, bytes, alignment);
+  }
+  [[nodiscard]] bool
+  do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+} // namespace
+
+TEST_CASE("RingBuffer with ResourceStorage", "[ring_buffer][storage]") {
+  CountingResource resource;
+
+  SECTION("Slots come from the given resource, cache-line aligned") {
+    {
+      bring::RingBuffer<std::string, 8, bring::ResourceStorage> buffer(
+          &resource);
+      REQUIRE(resource.allocations == 1);
+      REQUIRE(resource.last_alignment >= 64);
+      REQUIRE(resource.last_bytes >= 8 * sizeof(std::string));
+      REQUIRE(buffer.try_push(std::string(40, 'x')));
+      REQUIRE(buffer.try_pop().value() == std::string(40, 'x'));
+      REQUIRE(buffer.try_push("left behind"));
+    }
+    REQUIRE(resource.deallocations == 1);
+  }
+
+  SECTION("Dynamic capacity and move keep the resource") {
+    bring::DynamicRingBuffer<int, bring::ResourceStorage> buffer(16,
+                                                                 &resource);
+    REQUIRE(buffer.capacity() == 16);
+    REQUIRE(buffer.try_push(1));
+    auto moved = std::move(buffer);
+    REQUIRE(moved.try_pop().value() == 1);
+    REQUIRE(resource.allocations == 1);
+    REQUIRE(resource.deallocations == 0);
+  }
+
+  SECTION("Default construction uses the default resource") {
+    bring::RingBuffer<int, 4, bring::ResourceStorage> buffer;
+    REQUIRE(buffer.try_push(3));
+    REQUIRE(buffer.try_pop().value() == 3);
+  }
+}
+
+namespace {
+struct ThrowingMove {
+  int value{0};
+  ThrowingMove() = default;
+  ThrowingMove(const ThrowingMove &) = default;
+  // NOLINTNEXTLINE(performance-noexcept-move-constructor)
+  ThrowingMove(ThrowingMove &&other) noexcept(false) : value(other.value) {}
+  ThrowingMove &operator=(const ThrowingMove &) = default;
+  // NOLINTNEXTLINE(performance-noexcept-move-constructor)
+  ThrowingMove &operator=(ThrowingMove &&) noexcept(false) = default;
+  ~ThrowingMove() = default;
+};
+} // namespace
+
+TEST_CASE("RingBuffer with InlineStorage", "[ring_buffer][storage]") {
+  using Ring = bring::RingBuffer<std::string, 8, bring::InlineStorage>;
+
+  SECTION("Slots are embedded in the ring object") {
+    STATIC_REQUIRE(sizeof(Ring) >= 8 * sizeof(std::string));
+    STATIC_REQUIRE(alignof(Ring) >= 64);
+    Ring buffer;
+    REQUIRE(buffer.try_push(std::string(40, 'x')));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto begin = reinterpret_cast<uintptr_t>(&buffer);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto element = reinterpret_cast<uintptr_t>(buffer.peek(1).data());
+    REQUIRE(element >= begin);
+    REQUIRE(element < begin + sizeof(Ring));
+    REQUIRE(element % 64 == 0);
+    REQUIRE(buffer.try_pop().value() == std::string(40, 'x'));
+  }
+
+  SECTION("Move constructor moves the live elements across a wrap") {
+    Ring buffer;
+    for (int i = 0; i < 6; ++i) {
+      REQUIRE(buffer.try_push(std::to_string(i)));
+    }
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_pop());
+    }
+    for (int i = 6; i < 12; ++i) {
+      REQUIRE(buffer.try_push(std::to_string(i)));
+    }
+
+    Ring moved(std::move(buffer));
+    REQUIRE(buffer.is_empty());
+    REQUIRE(moved.size() == 8);
+    for (int i = 4; i < 12; ++i) {
+      REQUIRE(moved.try_pop().value() == std::to_string(i));
+    }
+
+    REQUIRE(buffer.try_push("source still usable"));
+    REQUIRE(buffer.try_pop().value() == "source still usable");
+  }
+
+  SECTION("Move assignment destroys the old elements") {
+    auto tracked = std::make_shared<int>(0);
+    using Owning = bring::RingBuffer<std::shared_ptr<int>, 4,
+                                     bring::InlineStorage>;
+    Owning target;
+    REQUIRE(target.try_push(tracked));
+    Owning source;
+    REQUIRE(source.try_push(std::make_shared<int>(7)));
+    REQUIRE(tracked.use_count() == 2);
+
+    target = std::move(source);
+    REQUIRE(tracked.use_count() == 1);
+    REQUIRE(source.is_empty());
+    REQUIRE(*target.try_pop().value() == 7);
+  }
+
+  SECTION("Moves are disabled for elements with a throwing move") {
+    using Throwing = bring::RingBuffer<ThrowingMove, 4, bring::InlineStorage>;
+    STATIC_REQUIRE_FALSE(std::is_move_constructible_v<Throwing>);
+    STATIC_REQUIRE_FALSE(std::is_move_assignable_v<Throwing>);
+    STATIC_REQUIRE(std::is_move_constructible_v<
+                   bring::RingBuffer<ThrowingMove, 4>>);
+    Throwing buffer;
+    REQUIRE(buffer.try_push(ThrowingMove{}));
+    REQUIRE(buffer.try_pop());
+  }
+}
+
+namespace {
+struct Tick {
+  uint64_t sequence;
+  double price;
+  double quantity;
+  uint32_t venue;
+  uint32_t flags;
+};
+static_assert(sizeof(Tick) == 32);
+} // namespace
+
+TEST_CASE("Trivially copyable bulk transfer", "[ring_buffer][bulk]") {
+  auto make_ticks = [](uint64_t first, size_t count) {
+    std::vector<Tick> ticks(count);
+    for (size_t i = 0; i < count; ++i) {
+      const uint64_t sequence = first + i;
+      ticks[i] = Tick{sequence, static_cast<double>(sequence) * 0.5, 1.0,
+                      static_cast<uint32_t>(sequence % 7), 0};
+    }
+    return ticks;
+  };
+
+  SECTION("Segments are copied across the wrap point") {
+    bring::RingBuffer<Tick, 16> buffer;
+    const std::vector<Tick> first = make_ticks(0, 11);
+    REQUIRE(buffer.try_push_n(std::span<const Tick>(first)) == 11);
+    std::vector<Tick> out(16);
+    REQUIRE(buffer.try_pop_n(std::span<Tick>(out).first(9)) == 9);
+
+    // Head is at 11 of 16, so this push wraps and is cut at free space
+    const std::vector<Tick> second = make_ticks(11, 20);
+    REQUIRE(buffer.try_push_n(std::span<const Tick>(second)) == 14);
+    REQUIRE(buffer.size() == 16);
+
+    REQUIRE(buffer.try_pop_n(out) == 16);
+    for (size_t i = 0; i < 16; ++i) {
+      REQUIRE(out[i].sequence == 9 + i);
+      REQUIRE(out[i].price == static_cast<double>(9 + i) * 0.5);
+      REQUIRE(out[i].venue == (9 + i) % 7);
+    }
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Inline storage moves elements bytewise") {
+    using Ring = bring::RingBuffer<Tick, 8, bring::InlineStorage>;
+    Ring buffer;
+    const std::vector<Tick> ticks = make_ticks(100, 8);
+    REQUIRE(buffer.try_push_n(std::span<const Tick>(ticks).first(5)) == 5);
+    REQUIRE(buffer.try_pop());
+    REQUIRE(buffer.try_pop());
+    REQUIRE(buffer.try_push_n(std::span<const Tick>(ticks).last(3)) == 3);
+
+    Ring moved;
+    moved = std::move(buffer);
+    REQUIRE(buffer.is_empty());
+    const std::vector<uint64_t> expected{102, 103, 104, 105, 106, 107};
+    for (const uint64_t sequence : expected) {
+      REQUIRE(moved.try_pop().value().sequence == sequence);
+    }
+  }
+
+  SECTION("Non-contiguous input still takes the element-wise path") {
+    bring::RingBuffer<int, 8> buffer;
+    const std::list<int> items{1, 2, 3};
+    REQUIRE(buffer.try_push_n(items.begin(), items.end()) == 3);
+    std::vector<int> out(3);
+    REQUIRE(buffer.try_pop_n(out) == 3);
+    REQUIRE(out == std::vector<int>{1, 2, 3});
+  }
+}
+
+namespace {
+std::vector<std::byte> make_record(size_t size, uint8_t seed) {
+  std::vector<std::byte> record(size);
+  for (size_t i = 0; i < size; ++i) {
+    record[i] = static_cast<std::byte>(seed + i);
+  }
+  return record;
+}
+
+bool same_bytes(std::span<const std::byte> lhs,
+                std::span<const std::byte> rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+} // namespace
+
+TEST_CASE("ByteRingBuffer variable-length records", "[byte_ring]") {
+  bring::ByteRingBuffer<256> buffer;
+
+  SECTION("Records keep their length and content") {
+    REQUIRE(buffer.is_empty());
+    REQUIRE(buffer.peek().empty());
+    const auto small = make_record(3, 1);
+    const auto large = make_record(100, 7);
+    REQUIRE(buffer.try_write(small));
+    REQUIRE(buffer.try_write(large));
+    // 8-byte header each, payloads padded to 8 bytes
+    REQUIRE(buffer.size_bytes() == 16 + 112);
+
+    REQUIRE(same_bytes(buffer.peek(), small));
+    buffer.release();
+    REQUIRE(buffer.try_consume([&](std::span<const std::byte> record) {
+      REQUIRE(same_bytes(record, large));
+    }));
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Reserved space is aligned and may be committed partially") {
+    const std::span<std::byte> space = buffer.reserve(64);
+    REQUIRE(space.size() == 64);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    REQUIRE(reinterpret_cast<uintptr_t>(space.data()) % 8 == 0);
+    space[0] = std::byte{42};
+    buffer.commit(1);
+    REQUIRE(buffer.size_bytes() == 16);
+    const auto record = buffer.peek();
+    REQUIRE(record.size() == 1);
+    REQUIRE(record[0] == std::byte{42});
+    buffer.release();
+  }
+
+  SECTION("A record that would wrap starts at offset 0 behind padding") {
+    const auto filler = make_record(150, 3);
+    REQUIRE(buffer.try_write(filler));
+    const std::byte *start = buffer.peek().data();
+    buffer.release();
+
+    // Only 96 bytes remain before the end, so this record goes to offset 0
+    const auto wrapped = make_record(120, 9);
+    const std::span<std::byte> space = buffer.reserve(wrapped.size());
+    REQUIRE(space.size() == wrapped.size());
+    REQUIRE(space.data() == start);
+    std::copy(wrapped.begin(), wrapped.end(), space.begin());
+    buffer.commit();
+    REQUIRE(buffer.size_bytes() == 96 + 128);
+
+    REQUIRE(same_bytes(buffer.peek(), wrapped));
+    buffer.release();
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Full ring refuses records until space is released") {
+    const auto record = make_record(56, 0);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_write(record));
+    }
+    REQUIRE(buffer.size_bytes() == 256);
+    REQUIRE_FALSE(buffer.try_write(make_record(1, 0)));
+    REQUIRE(buffer.reserve(1).empty());
+    buffer.try_consume([](std::span<const std::byte>) {});
+    REQUIRE(buffer.try_write(record));
+  }
+
+  SECTION("Record size limits") {
+    REQUIRE(buffer.max_record_size() == 248);
+    REQUIRE_THROWS_AS(buffer.reserve(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(buffer.reserve(249), std::invalid_argument);
+    REQUIRE(buffer.try_write(make_record(248, 5)));
+    REQUIRE(buffer.peek().size() == 248);
+  }
+
+  SECTION("Committing nothing publishes no record") {
+    const auto filler = make_record(248, 1);
+    REQUIRE(buffer.try_write(filler));
+    // Failed reserve: commit() has nothing to publish, a size is rejected
+    REQUIRE(buffer.reserve(8).empty());
+    buffer.commit();
+    REQUIRE_THROWS_AS(buffer.commit(1), std::invalid_argument);
+    REQUIRE(buffer.size_bytes() == 256);
+
+    buffer.try_consume([](std::span<const std::byte>) {});
+    REQUIRE(buffer.reserve(8).size() == 8);
+    buffer.commit(0);
+    REQUIRE(buffer.is_empty());
+    REQUIRE_THROWS_AS(buffer.commit(8), std::invalid_argument);
+
+    // The consumer is not stuck behind an empty record
+    const auto record = make_record(5, 2);
+    REQUIRE(buffer.try_write(record));
+    REQUIRE(buffer.try_consume([&](std::span<const std::byte> payload) {
+      REQUIRE(same_bytes(payload, record));
+    }));
+  }
+
+  SECTION("A failed reserve drops the reservation before it") {
+    REQUIRE(buffer.try_write(make_record(24, 1)));
+    REQUIRE(buffer.try_write(make_record(152, 2)));
+    REQUIRE(buffer.try_consume([](std::span<const std::byte>) {}));
+    REQUIRE(buffer.reserve(40).size() == 40);
+    // Does not fit after the wrap, which already published padding
+    REQUIRE(buffer.reserve(100).empty());
+    const size_t before = buffer.size_bytes();
+    buffer.commit();
+    REQUIRE_THROWS_AS(buffer.commit(40), std::invalid_argument);
+    REQUIRE(buffer.size_bytes() == before);
+    REQUIRE(buffer.size_bytes() <= buffer.capacity());
+
+    REQUIRE(buffer.try_consume([](std::span<const std::byte> payload) {
+      REQUIRE(same_bytes(payload, make_record(152, 2)));
+    }));
+    REQUIRE_FALSE(buffer.try_consume([](std::span<const std::byte>) {}));
+    REQUIRE(buffer.is_empty());
+  }
+}
+
+namespace {
+// Smallest coroutine type that runs eagerly and can be awaited nowhere
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+using CoroRing = bring::RingBuffer<std::string, 2, bring::CoroutineWait<>>;
+
+Detached pop_into(CoroRing &ring, std::vector<std::string> &out, int count) {
+  for (int i = 0; i < count; ++i) {
+    out.push_back(co_await ring.async_pop());
+  }
+}
+
+Detached push_all(CoroRing &ring, std::vector<std::string> items,
+                  bool &done) {
+  for (auto &item : items) {
+    co_await ring.async_push(std::move(item));
+  }
+  done = true;
+}
+
+struct QueueExecutor {
+  std::vector<std::coroutine_handle<>> *queue;
+  void operator()(std::coroutine_handle<> handle) const {
+    queue->push_back(handle);
+  }
+};
+
+Detached pop_on(CoroRing &ring, QueueExecutor executor, std::string &out) {
+  out = co_await ring.async_pop(executor);
+}
+
+// Records whether the resumed awaitable reported a broken SPSC contract
+Detached pop_checked(CoroRing &ring, QueueExecutor executor, bool &failed) {
+  try {
+    static_cast<void>(co_await ring.async_pop(executor));
+  } catch (const std::logic_error &) {
+    failed = true;
+  }
+}
+
+Detached push_checked(CoroRing &ring, std::string item,
+                      QueueExecutor executor, bool &failed) {
+  try {
+    co_await ring.async_push(std::move(item), executor);
+  } catch (const std::logic_error &) {
+    failed = true;
+  }
+}
+
+template <typename Ring>
+concept HasAsyncPop = requires(Ring &ring) { ring.async_pop(); };
+} // namespace
+
+TEST_CASE("RingBuffer coroutine awaitables", "[ring_buffer][coroutine]") {
+  CoroRing ring;
+
+  SECTION("Completes synchronously when data is ready") {
+    REQUIRE(ring.try_push("ready"));
+    std::vector<std::string> out;
+    pop_into(ring, out, 1);
+    REQUIRE(out == std::vector<std::string>{"ready"});
+  }
+
+  SECTION("A suspended consumer is resumed by the producer's push") {
+    std::vector<std::string> out;
+    pop_into(ring, out, 3);
+    REQUIRE(out.empty());
+    REQUIRE(ring.try_push("a"));
+    REQUIRE(out == std::vector<std::string>{"a"});
+    const std::vector<std::string> rest{"b", "c"};
+    REQUIRE(ring.try_push_n(rest.begin(), rest.end()) == 2);
+    REQUIRE(out == std::vector<std::string>{"a", "b", "c"});
+    REQUIRE(ring.is_empty());
+  }
+
+  SECTION("A suspended producer is resumed by the consumer's pop") {
+    bool done = false;
+    push_all(ring, {"1", "2", "3", "4"}, done);
+    REQUIRE_FALSE(done);
+    REQUIRE(ring.is_full());
+    REQUIRE(ring.try_pop().value() == "1");
+    REQUIRE_FALSE(done);
+    REQUIRE(ring.try_pop().value() == "2");
+    REQUIRE(done);
+    REQUIRE(ring.try_pop().value() == "3");
+    REQUIRE(ring.try_pop().value() == "4");
+  }
+
+  SECTION("Resumption goes through the executor") {
+    std::vector<std::coroutine_handle<>> queue;
+    std::string out;
+    pop_on(ring, QueueExecutor{&queue}, out);
+    REQUIRE(ring.try_push("posted"));
+    REQUIRE(queue.size() == 1);
+    REQUIRE(out.empty());
+    queue.front().resume();
+    REQUIRE(out == "posted");
+  }
+
+  SECTION("A resumed awaitable whose element was taken throws") {
+    std::vector<std::coroutine_handle<>> queue;
+    bool failed = false;
+    pop_checked(ring, QueueExecutor{&queue}, failed);
+    REQUIRE(ring.try_push("stolen"));
+    REQUIRE(queue.size() == 1);
+    // A second consumer breaks SPSC and takes the element first
+    REQUIRE(ring.try_pop().value() == "stolen");
+    queue.front().resume();
+    REQUIRE(failed);
+  }
+
+  SECTION("A resumed awaitable whose slot was taken throws") {
+    std::vector<std::coroutine_handle<>> queue;
+    bool failed = false;
+    REQUIRE(ring.try_push("1"));
+    REQUIRE(ring.try_push("2"));
+    push_checked(ring, "3", QueueExecutor{&queue}, failed);
+    REQUIRE(ring.try_pop().value() == "1");
+    REQUIRE(queue.size() == 1);
+    // A second producer breaks SPSC and fills the freed slot first
+    REQUIRE(ring.try_push("intruder"));
+    queue.front().resume();
+    REQUIRE(failed);
+    REQUIRE(ring.try_pop().value() == "2");
+    REQUIRE(ring.try_pop().value() == "intruder");
+  }
+
+  SECTION("Only rings with CoroutineWait are awaitable") {
+    STATIC_REQUIRE(HasAsyncPop<CoroRing>);
+    STATIC_REQUIRE_FALSE(HasAsyncPop<bring::RingBuffer<int, 4>>);
+  }
+}
+
+#if defined(__linux__)
+namespace {
+bool readable(int fd) {
+  pollfd entry{fd, POLLIN, 0};
+  return ::poll(&entry, 1, 0) == 1 && (entry.revents & POLLIN) != 0;
+}
+} // namespace
+
+TEST_CASE("RingBuffer EventFdWait notifications", "[ring_buffer][eventfd]") {
+  using Ring = bring::RingBuffer<int, 8, bring::EventFdWait<>>;
+  Ring ring;
+  const int fd = ring.native_handle();
+  REQUIRE(fd >= 0);
+
+  SECTION("Publishing without a sleeper leaves the eventfd quiet") {
+    REQUIRE(ring.try_push(1));
+    REQUIRE(ring.try_push(2));
+    REQUIRE_FALSE(readable(fd));
+  }
+
+  SECTION("An armed consumer is signalled once") {
+    REQUIRE(ring.arm_notification());
+    REQUIRE_FALSE(readable(fd));
+    REQUIRE(ring.try_push(1));
+    REQUIRE(readable(fd));
+    ring.acknowledge_notification();
+    REQUIRE_FALSE(readable(fd));
+
+    // The flag is cleared by the wakeup, later pushes stay quiet
+    REQUIRE(ring.try_push(2));
+    REQUIRE_FALSE(readable(fd));
+    REQUIRE(ring.try_pop().value() == 1);
+    REQUIRE(ring.try_pop().value() == 2);
+  }
+
+  SECTION("Arming with data pending refuses to sleep") {
+    REQUIRE(ring.try_push(1));
+    REQUIRE_FALSE(ring.arm_notification());
+    REQUIRE(ring.try_push(2));
+    REQUIRE_FALSE(readable(fd));
+  }
+
+  SECTION("pop_wait_for sleeps in poll until the timeout") {
+    using namespace std::chrono_literals;
+    bring::RingBuffer<int, 8, bring::EventFdWait<0>> sleeper;
+    const auto start = std::chrono::steady_clock::now();
+    const std::clock_t cpu_start = std::clock();
+    REQUIRE_FALSE(sleeper.pop_wait_for(50ms).has_value());
+    const double cpu_seconds =
+        static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    REQUIRE(std::chrono::steady_clock::now() - start >= 50ms);
+    REQUIRE(cpu_seconds < 0.025);
+
+    // The timeout disarmed the consumer, so a later push stays quiet
+    REQUIRE(sleeper.try_push(1));
+    REQUIRE_FALSE(readable(sleeper.native_handle()));
+  }
+
+  SECTION("Moving the ring keeps the descriptor") {
+    Ring moved(std::move(ring));
+    REQUIRE(moved.native_handle() == fd);
+    REQUIRE(moved.arm_notification());
+    REQUIRE(moved.try_push(1));
+    REQUIRE(readable(fd));
+  }
+}
+#endif
+
+TEST_CASE("RingBuffer deferred publication", "[ring_buffer][publish]") {
+  SECTION("Manual mode: pushes become visible on publish()") {
+    bring::RingBuffer<int, 8, bring::DeferredPublish<>> ring;
+    REQUIRE(ring.try_push(1));
+    REQUIRE(ring.try_push(2));
+    REQUIRE(ring.size() == 0);
+    REQUIRE_FALSE(ring.try_pop());
+    ring.publish();
+    REQUIRE(ring.size() == 2);
+    REQUIRE(ring.try_pop().value() == 1);
+    // The consumer's pop is not visible to the producer yet
+    REQUIRE(ring.size() == 2);
+    ring.release_consumed();
+    REQUIRE(ring.size() == 1);
+  }
+
+  SECTION("A side that finds the ring full or empty publishes") {
+    bring::RingBuffer<int, 4, bring::DeferredPublish<>> ring;
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(ring.try_push(i));
+    }
+    // Full: the failing push publishes the four pending elements
+    REQUIRE_FALSE(ring.try_push(4));
+    REQUIRE(ring.size() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(ring.try_pop().value() == i);
+    }
+    REQUIRE(ring.size() == 4);
+    // Empty: the failing pop hands the four slots back
+    REQUIRE_FALSE(ring.try_pop());
+    REQUIRE(ring.size() == 0);
+    REQUIRE(ring.try_push(4));
+  }
+
+  SECTION("Interval publishes every N elements") {
+    bring::RingBuffer<int, 16, bring::DeferredPublish<4>, bring::RingStats>
+        ring;
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(ring.try_push(i));
+    }
+    REQUIRE(ring.size() == 0);
+    REQUIRE(ring.try_push(3));
+    REQUIRE(ring.size() == 4);
+    const std::vector<int> more{4, 5, 6, 7, 8};
+    REQUIRE(ring.try_push_n(std::span<const int>(more)) == 5);
+    REQUIRE(ring.size() == 9);
+    REQUIRE(ring.stats().pushes == 9);
+
+    std::vector<int> out(3);
+    REQUIRE(ring.try_pop_n(out) == 3);
+    REQUIRE(ring.size() == 9);
+    REQUIRE(ring.try_pop());
+    REQUIRE(ring.size() == 5);
+    REQUIRE(ring.stats().pops == 4);
+  }
+
+  SECTION("Zero-copy and move keep pending elements") {
+    bring::RingBuffer<std::string, 8, bring::DeferredPublish<>> ring;
+    const std::span<std::string> space = ring.reserve(2);
+    REQUIRE(space.size() == 2);
+    std::construct_at(&space[0], "first");
+    std::construct_at(&space[1], "second");
+    ring.commit(2);
+    REQUIRE(ring.try_push("third"));
+    REQUIRE(ring.size() == 0);
+
+    auto moved = std::move(ring);
+    moved.publish();
+    REQUIRE(moved.size() == 3);
+    REQUIRE(moved.peek(1)[0] == "first");
+    moved.release(1);
+    REQUIRE(moved.try_pop().value() == "second");
+    REQUIRE(moved.size() == 3);
+    moved.release_consumed();
+    REQUIRE(moved.size() == 1);
+  }
+}
+
+TEST_CASE("RingBuffer padding policies", "[ring_buffer][layout]") {
+  using Default = bring::RingBuffer<int, 8>;
+  using Wide = bring::RingBuffer<int, 8, bring::Padding128>;
+  using WideParking =
+      bring::RingBuffer<int, 8, bring::AtomicWait<>, bring::Padding128>;
+
+  STATIC_REQUIRE(Default::layout().line_size ==
+                 bring::destructive_interference_size);
+  STATIC_REQUIRE(Wide::layout().line_size == 128);
+  STATIC_REQUIRE(Wide::layout().separated());
+  STATIC_REQUIRE(alignof(Wide) == 128);
+  STATIC_REQUIRE(Wide::layout().tail - Wide::layout().head >= 256);
+  STATIC_REQUIRE(WideParking::layout().size % 128 == 0);
+
+  SECTION("Stateful policies take the ring's line size") {
+    using WideStats =
+        bring::RingBuffer<int, 8, bring::RingStats, bring::LatencySampling<>,
+                          bring::Padding128>;
+    STATIC_REQUIRE(std::same_as<WideParking::wait_strategy,
+                                bring::AtomicWait<64, 128>>);
+    STATIC_REQUIRE(std::same_as<Default::stats_policy, bring::NoStats>);
+    STATIC_REQUIRE(
+        std::same_as<bring::RingBuffer<int, 8, bring::RingStats>::stats_policy,
+                     bring::RingStats>);
+    STATIC_REQUIRE(
+        std::same_as<WideStats::stats_policy, bring::BasicRingStats<128>>);
+    STATIC_REQUIRE(alignof(WideStats::latency_policy) == 128);
+
+    STATIC_REQUIRE(Default::layout().wait == bring::RingLayout::absent);
+    STATIC_REQUIRE(Default::layout().stats == bring::RingLayout::absent);
+    STATIC_REQUIRE(WideParking::layout().wait % 128 == 0);
+    STATIC_REQUIRE(WideParking::layout().wait >=
+                   WideParking::layout().shared + 128);
+    STATIC_REQUIRE(WideStats::layout().separated());
+    STATIC_REQUIRE(WideStats::layout().stats % 128 == 0);
+    // Producer and consumer counters both sit in the stats group
+    STATIC_REQUIRE(WideStats::layout().latency - WideStats::layout().stats >=
+                   256);
+    STATIC_REQUIRE(
+        alignof(bring::RingSet<int, 8, 4, bring::Padding128>) == 128);
+  }
+
+  SECTION("Padded rings work like the default") {
+    WideParking buffer;
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_pop().value() == 1);
+    auto heap = std::make_unique<Wide>();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    REQUIRE(reinterpret_cast<std::uintptr_t>(heap.get()) % 128 == 0);
+  }
+
+  SECTION("A layout with two groups on one line is reported") {
+    bring::RingLayout layout = Default::layout();
+    layout.tail = layout.producer_cache;
+    REQUIRE_FALSE(layout.separated());
+
+    bring::RingLayout parking = WideParking::layout();
+    REQUIRE(parking.separated());
+    parking.wait = parking.shared + 8;
+    REQUIRE_FALSE(parking.separated());
+  }
+}
+
+TEST_CASE("OverwriteRingBuffer drops the oldest entries", "[overwrite]") {
+  bring::OverwriteRingBuffer<uint64_t, 8> buffer;
+
+  SECTION("Behaves like a FIFO while the consumer keeps up") {
+    buffer.push(1);
+    buffer.push(2);
+    REQUIRE(buffer.size() == 2);
+    REQUIRE(buffer.try_pop().value() == 1);
+    REQUIRE(buffer.try_pop().value() == 2);
+    REQUIRE_FALSE(buffer.try_pop().has_value());
+    REQUIRE(buffer.lost() == 0);
+  }
+
+  SECTION("The producer never fails and keeps the newest Capacity - 1") {
+    for (uint64_t i = 0; i < 20; ++i) {
+      buffer.push(i);
+    }
+    REQUIRE(buffer.size() == 7);
+    std::vector<uint64_t> seen;
+    REQUIRE(buffer.consume_n(100, [&](const uint64_t &v) {
+      seen.push_back(v);
+    }) == 7);
+    REQUIRE(seen == std::vector<uint64_t>{13, 14, 15, 16, 17, 18, 19});
+    REQUIRE(buffer.lost() == 13);
+    REQUIRE(buffer.is_empty());
+  }
+
+  SECTION("Losses accumulate across laps") {
+    for (uint64_t i = 0; i < 10; ++i) {
+      buffer.push(i);
+    }
+    REQUIRE(buffer.try_pop().value() == 3);
+    for (uint64_t i = 10; i < 30; ++i) {
+      buffer.push(i);
+    }
+    REQUIRE(buffer.try_pop().value() == 23);
+    REQUIRE(buffer.lost() == 3 + 19);
+  }
+}
+
+TEST_CASE("OverwriteRingBuffer copies multi-word elements", "[overwrite]") {
+  struct Sample {
+    uint32_t id;
+    std::array<double, 3> values;
+  };
+  bring::OverwriteRingBuffer<Sample, 4> buffer;
+  buffer.push(Sample{7, {1.5, 2.5, 3.5}});
+  const Sample out = buffer.try_pop().value();
+  REQUIRE(out.id == 7);
+  REQUIRE(out.values.at(2) == 3.5);
+}
+
+TEST_CASE("RingSet polls only ready rings", "[ring_set]") {
+  bring::RingSet<int, 8, 70> rings;
+  std::vector<std::pair<size_t, int>> seen;
+  const auto record = [&](size_t ring, int &&value) {
+    seen.emplace_back(ring, value);
+  };
+
+  SECTION("Idle rings are not marked") {
+    REQUIRE_FALSE(rings.any_ready());
+    REQUIRE(rings.poll(record) == 0);
+  }
+
+  SECTION("A push marks its ring and a pass that finds it empty clears it") {
+    REQUIRE(rings.ring(66).try_push(1));
+    REQUIRE(rings.ring(3).try_push(2));
+    REQUIRE(rings.any_ready());
+    REQUIRE(rings.poll(record) == 2);
+    REQUIRE(seen == std::vector<std::pair<size_t, int>>{{3, 2}, {66, 1}});
+    REQUIRE(rings.any_ready());
+    REQUIRE(rings.poll(record) == 0);
+    REQUIRE_FALSE(rings.any_ready());
+  }
+
+  SECTION("Batch limits bound each ring's share of a pass") {
+    rings.set_batch_limit(0, 1);
+    rings.set_batch_limit(1, 3);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(rings.ring(0).try_push(i));
+      REQUIRE(rings.ring(1).try_push(10 + i));
+    }
+    REQUIRE(rings.poll(record) == 4);
+    REQUIRE(seen == std::vector<std::pair<size_t, int>>{
+                        {0, 0}, {1, 10}, {1, 11}, {1, 12}});
+    // Both rings still hold elements, so both stay marked
+    REQUIRE(rings.any_ready());
+    REQUIRE_THROWS_AS(rings.set_batch_limit(0, 0), std::invalid_argument);
+  }
+
+  SECTION("Passes start at a different ring each time") {
+    REQUIRE(rings.ring(0).try_push(1));
+    REQUIRE(rings.poll(record) == 1);
+    REQUIRE(rings.ring(0).try_push(2));
+    REQUIRE(rings.ring(1).try_push(3));
+    REQUIRE(rings.poll(record) == 2);
+    REQUIRE(seen.at(1) == std::pair<size_t, int>{1, 3});
+    REQUIRE(seen.at(2) == std::pair<size_t, int>{0, 2});
+  }
+
+  SECTION("poll_wait returns immediately when a ring is ready") {
+    REQUIRE(rings.ring(42).try_push(5));
+    REQUIRE(rings.poll_wait(record) == 1);
+    REQUIRE(seen.at(0) == std::pair<size_t, int>{42, 5});
+  }
+}
+
+TEST_CASE("PoolChannel recycles its buffers", "[pool_channel]") {
+  int initialised = 0;
+  bring::PoolChannel<std::vector<int>, 4> channel(
+      [&initialised](std::vector<int> &buffer) {
+        buffer.reserve(64);
+        ++initialised;
+      });
+  REQUIRE(initialised == 4);
+  REQUIRE(channel.available() == 4);
+
+  SECTION("every buffer can be in flight at once") {
+    std::vector<const int *> sent;
+    for (int i = 0; i < 4; ++i) {
+      auto lease = channel.try_acquire();
+      REQUIRE(lease.has_value());
+      (*lease)->assign({i, i + 1});
+      sent.push_back((*lease)->data());
+      channel.send(std::move(*lease));
+    }
+    REQUIRE_FALSE(channel.try_acquire().has_value());
+    REQUIRE(channel.available() == 0);
+
+    for (int i = 0; i < 4; ++i) {
+      auto message = channel.try_receive();
+      REQUIRE(message.has_value());
+      REQUIRE(**message == std::vector<int>{i, i + 1});
+      REQUIRE((*message)->data() == sent.at(static_cast<size_t>(i)));
+    }
+    // Each message went back to the pool at the end of its iteration
+    REQUIRE_FALSE(channel.try_receive().has_value());
+    REQUIRE(channel.available() == 4);
+
+    // Returned buffers keep their allocation
+    for (int i = 0; i < 4; ++i) {
+      auto lease = channel.acquire_wait();
+      REQUIRE(lease->capacity() >= 64);
+      REQUIRE(std::find(sent.begin(), sent.end(), lease->data()) !=
+              sent.end());
+      channel.send(std::move(lease));
+    }
+    while (channel.try_receive()) {
+    }
+  }
+
+  SECTION("only live leases from this channel can be sent") {
+    auto lease = channel.acquire_wait();
+    auto moved = std::move(lease);
+    // NOLINTNEXTLINE(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+    REQUIRE_THROWS_AS(channel.send(std::move(lease)), std::invalid_argument);
+    channel.send(std::move(moved));
+    // NOLINTNEXTLINE(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+    REQUIRE_THROWS_AS(channel.send(std::move(moved)), std::invalid_argument);
+
+    bring::PoolChannel<std::vector<int>, 4> other;
+    auto foreign = other.acquire_wait();
+    REQUIRE_THROWS_AS(channel.send(std::move(foreign)), std::invalid_argument);
+    REQUIRE(other.available() == 3);
+
+    // Only the one buffer that was sent is in flight
+    REQUIRE(channel.available() == 3);
+    REQUIRE(channel.try_receive().has_value());
+    REQUIRE_FALSE(channel.try_receive().has_value());
+    REQUIRE(channel.available() == 4);
+  }
+
+  SECTION("an unsent lease goes back on the free stack") {
+    const int *first = nullptr;
+    {
+      auto lease = channel.acquire_wait();
+      first = lease->data();
+      REQUIRE(channel.available() == 3);
+    }
+    REQUIRE(channel.available() == 4);
+    // Most recently freed first
+    REQUIRE(channel.acquire_wait()->data() == first);
+  }
+
+  SECTION("the most recently returned buffer is reused first") {
+    for (int i = 0; i < 4; ++i) {
+      channel.send(channel.acquire_wait());
+    }
+    std::vector<const int *> returned;
+    while (auto message = channel.try_receive()) {
+      returned.push_back((*message)->data());
+    }
+    REQUIRE(returned.size() == 4);
+    REQUIRE(channel.acquire_wait()->data() == returned.back());
+  }
+
+  SECTION("moving a message keeps a single owner") {
+    channel.send(channel.acquire_wait());
+    auto message = channel.try_receive();
+    REQUIRE(message.has_value());
+    auto moved = std::move(*message);
+    message.reset();
+    REQUIRE(channel.available() == 3);
+    REQUIRE_FALSE(channel.receive_wait_for(std::chrono::milliseconds(1))
+                      .has_value());
+  }
+  REQUIRE(channel.available() == 4);
+}
+
+TEST_CASE("LatencyHistogram percentiles", "[latency]") {
+  bring::LatencyHistogram histogram;
+  REQUIRE(histogram.count() == 0);
+  REQUIRE(histogram.percentile(0.99) == 0);
+
+  for (uint64_t value = 0; value < 100; ++value) {
+    histogram.record(value);
+  }
+  REQUIRE(histogram.count() == 100);
+  REQUIRE(histogram.max() == 99);
+  REQUIRE(histogram.percentile(0.1) == 10);
+  REQUIRE(histogram.percentile(0.5) >= 50);
+  REQUIRE(histogram.percentile(0.5) <= 53);
+  REQUIRE(histogram.percentile(1.0) == 99);
+
+  histogram.record(uint64_t{1} << 60);
+  REQUIRE(histogram.max() == (uint64_t{1} << 48) - 1);
+
+  // One more sub-bucket bit: exact up to 63, two-wide buckets above
+  bring::BasicLatencyHistogram<5> fine;
+  for (uint64_t value = 0; value < 100; ++value) {
+    fine.record(value);
+  }
+  REQUIRE(fine.percentile(0.5) == 50);
+  REQUIRE(fine.percentile(0.9) == 91);
+}
+
+TEST_CASE("RingBuffer latency sampling", "[ring_buffer][latency]") {
+  STATIC_REQUIRE(
+      sizeof(bring::RingBuffer<int, 16>) ==
+      sizeof(bring::RingBuffer<int, 16, bring::NoLatencySampling>));
+
+  SECTION("every Nth position is sampled") {
+    bring::RingBuffer<int, 16, bring::LatencySampling<4, 8>> buffer;
+    for (int i = 0; i < 16; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    REQUIRE(buffer.latency().count() == 0);
+    for (int i = 0; i < 6; ++i) {
+      REQUIRE(buffer.try_pop() == i);
+    }
+    // Positions 0 and 4
+    REQUIRE(buffer.latency().count() == 2);
+    REQUIRE(buffer.consume_all([](int && /*value*/) {}) == 10);
+    REQUIRE(buffer.latency().count() == 4);
+
+    const std::array<int, 10> values{};
+    REQUIRE(buffer.try_push_n(std::span<const int>(values)) == 10);
+    std::array<int, 10> out{};
+    REQUIRE(buffer.try_pop_n(out) == 10);
+    // Positions 16, 20 and 24
+    REQUIRE(buffer.latency().count() == 7);
+    REQUIRE(buffer.latency().percentile(0.5) <= buffer.latency().max());
+  }
+
+  SECTION("samples whose entry was reused are dropped") {
+    bring::RingBuffer<int, 16, bring::LatencySampling<1, 4>> buffer;
+    for (int i = 0; i < 16; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    REQUIRE(buffer.consume_all([](int && /*value*/) {}) == 16);
+    // Only positions 12 to 15 still own their entries
+    REQUIRE(buffer.latency().count() == 4);
+  }
+
+  SECTION("a moved-to ring starts with no stamps") {
+    bring::RingBuffer<int, 16, bring::LatencySampling<1, 16>> buffer;
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(buffer.try_push(i));
+    }
+    auto moved = std::move(buffer);
+    REQUIRE(moved.consume_all([](int && /*value*/) {}) == 8);
+    REQUIRE(moved.latency().count() == 0);
+  }
+}
+
+TEST_CASE("PriorityRingBuffer strict priority", "[priority]") {
+  bring::PriorityRingBuffer<int, bring::Lanes<4, 16>> buffer;
+  STATIC_REQUIRE(decltype(buffer)::lanes == 2);
+  STATIC_REQUIRE(decltype(buffer)::capacities() == std::array<size_t, 2>{4, 16});
+  REQUIRE(buffer.is_empty());
+  REQUIRE_FALSE(buffer.try_pop().has_value());
+
+  for (int i = 0; i < 16; ++i) {
+    REQUIRE(buffer.try_push(1, 100 + i));
+  }
+  REQUIRE_FALSE(buffer.try_push(1, 0));
+  // Each lane has its own capacity
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(buffer.emplace(0, i));
+  }
+  REQUIRE_FALSE(buffer.try_push(0, 0));
+  REQUIRE_FALSE(buffer.try_push(2, 0));
+  REQUIRE(buffer.size() == 20);
+  REQUIRE(buffer.ready_lanes() == 0b11);
+
+  // The urgent lane overtakes the backlog
+  REQUIRE(buffer.try_pop() == 0);
+  std::vector<int> seen;
+  const auto collect = [&seen](int &&value) { seen.push_back(value); };
+  // A batch never mixes lanes
+  REQUIRE(buffer.consume_n(8, collect) == 3);
+  REQUIRE(seen == std::vector<int>{1, 2, 3});
+  REQUIRE(buffer.ready_lanes() == 0b10);
+
+  seen.clear();
+  REQUIRE(buffer.consume_n(4, collect) == 4);
+  REQUIRE(buffer.try_push(0, 7));
+  REQUIRE(buffer.try_consume(collect));
+  REQUIRE(seen == std::vector<int>{100, 101, 102, 103, 7});
+  REQUIRE(buffer.consume_n(100, collect) == 12);
+  REQUIRE(seen.back() == 115);
+  REQUIRE(buffer.is_empty());
+  REQUIRE(buffer.consume_n(100, collect) == 0);
+}
+
+TEST_CASE("PriorityRingBuffer weighted priority", "[priority]") {
+  bring::PriorityRingBuffer<std::string, bring::Lanes<64, 64, 64>,
+                            bring::WeightedPriority<4, 2, 1>>
+      buffer;
+  for (int i = 0; i < 28; ++i) {
+    for (size_t lane = 0; lane < 3; ++lane) {
+      REQUIRE(buffer.try_push(lane, std::to_string(lane)));
+    }
+  }
+
+  std::string order;
+  const auto collect = [&order](std::string &&value) { order += value; };
+  // Batches are cut at the lane's weight
+  REQUIRE(buffer.consume_n(100, collect) == 4);
+  REQUIRE(buffer.consume_n(100, collect) == 2);
+  REQUIRE(buffer.consume_n(100, collect) == 1);
+  REQUIRE(order == "0000112");
+
+  // Single pops follow the same turns
+  order.clear();
+  for (int i = 0; i < 7; ++i) {
+    REQUIRE(buffer.try_consume(collect));
+  }
+  REQUIRE(order == "0000112");
+
+  // Under load the shares follow the weights
+  std::array<size_t, 3> counts{};
+  for (int i = 0; i < 5 * 7; ++i) {
+    REQUIRE(buffer.try_consume([&counts](std::string &&value) {
+      ++counts.at(static_cast<size_t>(value.at(0) - '0'));
+    }));
+  }
+  REQUIRE(counts == std::array<size_t, 3>{20, 10, 5});
+
+  // Lane 0 has run dry: its turns go to the others without starving them
+  order.clear();
+  while (buffer.consume_n(100, collect) > 0) {
+  }
+  REQUIRE(order.size() == 21 - 7 + 28 - 7);
+  REQUIRE(order.substr(0, 3) == "112");
+  REQUIRE(buffer.is_empty());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("MappedMemoryResource", "[storage]") {
+  using Ring = bring::RingBuffer<uint64_t, 4096, bring::ResourceStorage>;
+
+  auto exercise = [](Ring &buffer) {
+    for (uint64_t lap = 0; lap < 3; ++lap) {
+      for (uint64_t i = 0; i < buffer.capacity(); ++i) {
+        REQUIRE(buffer.try_push(i));
+      }
+      for (uint64_t i = 0; i < buffer.capacity(); ++i) {
+        REQUIRE(buffer.try_pop().value() == i);
+      }
+    }
+  };
+
+  SECTION("Regular pages, prefaulted") {
+    bring::MappedMemoryOptions options;
+    options.prefault = true;
+    bring::MappedMemoryResource resource(options);
+    Ring buffer(&resource);
+    exercise(buffer);
+  }
+
+  SECTION("Transparent huge pages") {
+    bring::MappedMemoryOptions options;
+    options.pages = bring::PageSize::Transparent;
+    bring::MappedMemoryResource resource(options);
+    Ring buffer(&resource);
+    exercise(buffer);
+  }
+
+  SECTION("Reserved huge pages work or fail with bad_alloc") {
+    bring::MappedMemoryOptions options;
+    options.pages = bring::PageSize::Huge2M;
+    bring::MappedMemoryResource resource(options);
+    try {
+      Ring buffer(&resource);
+      exercise(buffer);
+    } catch (const std::bad_alloc &) {
+      SUCCEED("no 2 MiB huge pages reserved on this machine");
+    }
+  }
+
+#if defined(__linux__)
+  SECTION("NUMA binding to node 0 works or reports the mbind error") {
+    bring::MappedMemoryOptions options;
+    options.numa_node = 0;
+    options.prefault = true;
+    bring::MappedMemoryResource resource(options);
+    try {
+      Ring buffer(&resource);
+      exercise(buffer);
+    } catch (const std::system_error &) {
+      SUCCEED("mbind is not available on this machine");
+    }
+  }
+#endif
+
+  SECTION("Out of range NUMA nodes are rejected") {
+    bring::MappedMemoryOptions options;
+    options.numa_node = -1;
+    REQUIRE_THROWS_AS(bring::MappedMemoryResource(options),
+                      std::invalid_argument);
+  }
+}
+#endif
+
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,bugprone-chained-comparison,readability-identifier-length,bugprone-unchecked-optional-access,bugprone-use-after-move,readability-function-cognitive-complexity,readability-identifier-naming)
@@ -1,9 +1,42 @@
+#include <bring/broadcast_ring_buffer.hpp>
+#include <bring/byte_ring_buffer.hpp>
+#include <bring/mpmc_ring_buffer.hpp>
+#include <bring/mpsc_ring_buffer.hpp>
+#include <bring/overwrite_ring_buffer.hpp>
+#include <bring/pipeline.hpp>
+#include <bring/pool_channel.hpp>
+#include <bring/priority_ring_buffer.hpp>
 #include <bring/ring_buffer.hpp>
+#include <bring/ring_set.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <array>
 #include <atomic>
 #include <thread>
 #include <vector>
 #include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <bring/shm_ring_buffer.hpp>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <bring/eventfd_wait.hpp>
+#include <sys/epoll.h>
+#endif
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,bugprone-unchecked-optional-access,bugprone-chained-comparison,readability-identifier-length,readability-function-cognitive-complexity,readability-identifier-naming)
 
@@ -540,4 +573,1024 @@ TEST_CASE("RingBuffer is_full consistency", "[ring_buffer][threading]") {
   INFO("Times producer observed full buffer: " << full_spin_count.load());
 }
 
+TEST_CASE("RingBuffer SPSC bulk transfer", "[ring_buffer][threading][bulk]") {
+  constexpr size_t NUM_ITEMS = 1000000;
+  constexpr size_t CAPACITY = 256;
+  constexpr size_t BATCH = 64;
+
+  bring::RingBuffer<uint64_t, CAPACITY> buffer;
+
+  std::thread producer([&]() {
+    std::array<uint64_t, BATCH> batch{};
+    uint64_t next = 0;
+    while (next < NUM_ITEMS) {
+      const size_t count = std::min<size_t>(BATCH, NUM_ITEMS - next);
+      for (size_t i = 0; i < count; ++i) {
+        batch.at(i) = next + i;
+      }
+      size_t sent = 0;
+      while (sent < count) {
+        const size_t pushed = buffer.try_push_n(
+            std::span<const uint64_t>(batch.data() + sent, count - sent));
+        if (pushed == 0) {
+          std::this_thread::yield();
+        }
+        sent += pushed;
+      }
+      next += count;
+    }
+  });
+
+  uint64_t expected = 0;
+  bool in_order = true;
+  std::thread consumer([&]() {
+    std::array<uint64_t, BATCH> out{};
+    while (expected < NUM_ITEMS) {
+      if (expected % 2 == 0) {
+        const size_t popped = buffer.try_pop_n(std::span<uint64_t>(out));
+        for (size_t i = 0; i < popped; ++i) {
+          in_order = in_order && out.at(i) == expected;
+          ++expected;
+        }
+        if (popped == 0) {
+          std::this_thread::yield();
+        }
+      } else {
+        const auto check = [&](uint64_t value) {
+          in_order = in_order && value == expected;
+          ++expected;
+        };
+        const size_t consumed = expected % 4 == 1
+                                    ? buffer.consume_n(BATCH, check)
+                                    : buffer.consume_all<8, 16>(check);
+        if (consumed == 0) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(expected == NUM_ITEMS);
+  REQUIRE(buffer.is_empty());
+}
+
+TEST_CASE("RingBuffer SPSC reserve/commit and peek/release", "[ring_buffer][threading][zero_copy]") {
+  constexpr size_t NUM_ITEMS = 1000000;
+  constexpr size_t CAPACITY = 128;
+  constexpr size_t BATCH = 32;
+
+  bring::RingBuffer<uint64_t, CAPACITY> buffer;
+
+  std::thread producer([&]() {
+    uint64_t next = 0;
+    while (next < NUM_ITEMS) {
+      auto slots = buffer.reserve(std::min<size_t>(BATCH, NUM_ITEMS - next));
+      if (slots.empty()) {
+        std::this_thread::yield();
+        continue;
+      }
+      for (auto &slot : slots) {
+        std::construct_at(&slot, next++);
+      }
+      buffer.commit(slots.size());
+    }
+  });
+
+  uint64_t expected = 0;
+  bool in_order = true;
+  std::thread consumer([&]() {
+    while (expected < NUM_ITEMS) {
+      auto ready = buffer.peek(BATCH);
+      if (ready.empty()) {
+        std::this_thread::yield();
+        continue;
+      }
+      for (const auto value : ready) {
+        in_order = in_order && value == expected;
+        ++expected;
+      }
+      buffer.release(ready.size());
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(expected == NUM_ITEMS);
+}
+
+TEST_CASE("DynamicRingBuffer SPSC multi-threaded", "[dynamic_ring_buffer][threading]") {
+  constexpr size_t NUM_ITEMS = 1000000;
+
+  bring::DynamicRingBuffer<uint64_t> buffer(64);
+
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+      while (!buffer.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint64_t expected = 0;
+  bool in_order = true;
+  std::thread consumer([&]() {
+    while (expected < NUM_ITEMS) {
+      auto result = buffer.try_pop();
+      if (result.has_value()) {
+        in_order = in_order && result.value() == expected;
+        ++expected;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(buffer.is_empty());
+}
+
+namespace {
+template <typename Ring>
+void run_blocking_transfer(Ring &buffer, uint64_t num_items) {
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < num_items; ++i) {
+      buffer.push_wait(i);
+    }
+  });
+
+  bool in_order = true;
+  std::thread consumer([&]() {
+    for (uint64_t i = 0; i < num_items; ++i) {
+      in_order = in_order && buffer.pop_wait() == i;
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(buffer.is_empty());
+}
+} // namespace
+
+TEST_CASE("RingBuffer SPSC blocking push_wait/pop_wait", "[ring_buffer][threading][wait]") {
+  constexpr uint64_t NUM_ITEMS = 200000;
+
+  SECTION("BusySpinWait") {
+    // Larger ring so a spinning side rarely has to wait out a whole time
+    // slice when both threads share a core
+    bring::RingBuffer<uint64_t, 1024, bring::BusySpinWait> buffer;
+    run_blocking_transfer(buffer, NUM_ITEMS);
+  }
+
+  SECTION("SpinYieldWait") {
+    bring::RingBuffer<uint64_t, 16, bring::SpinYieldWait<>> buffer;
+    run_blocking_transfer(buffer, NUM_ITEMS);
+  }
+
+  SECTION("AtomicWait") {
+    bring::RingBuffer<uint64_t, 16, bring::AtomicWait<>> buffer;
+    run_blocking_transfer(buffer, NUM_ITEMS);
+  }
+
+  SECTION("AtomicWait without spinning always parks") {
+    bring::RingBuffer<uint64_t, 4, bring::AtomicWait<0>> buffer;
+    run_blocking_transfer(buffer, NUM_ITEMS);
+  }
+}
+
+TEST_CASE("RingBuffer AtomicWait wakes a parked consumer", "[ring_buffer][threading][wait]") {
+  using namespace std::chrono_literals;
+  bring::RingBuffer<int, 8, bring::AtomicWait<0>> buffer;
+
+  std::atomic<bool> received{false};
+  int value = 0;
+  std::thread consumer([&]() {
+    value = buffer.pop_wait();
+    received.store(true, std::memory_order_release);
+  });
+
+  // Give the consumer time to park before publishing
+  std::this_thread::sleep_for(20ms);
+  REQUIRE_FALSE(received.load(std::memory_order_acquire));
+  REQUIRE(buffer.try_push(42));
+  consumer.join();
+  REQUIRE(received.load());
+  REQUIRE(value == 42);
+}
+
+TEST_CASE("MpscRingBuffer multiple producers", "[mpsc][threading]") {
+  constexpr uint64_t NUM_PRODUCERS = 4;
+  constexpr uint64_t ITEMS_PER_PRODUCER = 50000;
+
+  // Each item encodes its producer in the high bits so the consumer can check
+  // that every producer's items arrive in the order that producer sent them
+  bring::MpscRingBuffer<uint64_t, 64> buffer;
+  std::vector<std::thread> producers;
+  producers.reserve(NUM_PRODUCERS);
+  for (uint64_t p = 0; p < NUM_PRODUCERS; ++p) {
+    producers.emplace_back([&buffer, p]() {
+      for (uint64_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+        while (!buffer.try_push((p << 32U) | i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<uint64_t> next(NUM_PRODUCERS, 0);
+  bool in_order = true;
+  uint64_t received = 0;
+  while (received < NUM_PRODUCERS * ITEMS_PER_PRODUCER) {
+    auto value = buffer.try_pop();
+    if (!value) {
+      std::this_thread::yield();
+      continue;
+    }
+    const uint64_t producer = *value >> 32U;
+    const uint64_t seq = *value & 0xFFFFFFFFU;
+    in_order = in_order && producer < NUM_PRODUCERS && next[producer] == seq;
+    if (producer < NUM_PRODUCERS) {
+      next[producer] = seq + 1;
+    }
+    ++received;
+  }
+
+  for (auto &t : producers) {
+    t.join();
+  }
+  REQUIRE(in_order);
+  REQUIRE(buffer.is_empty());
+  for (uint64_t p = 0; p < NUM_PRODUCERS; ++p) {
+    REQUIRE(next[p] == ITEMS_PER_PRODUCER);
+  }
+}
+
+TEST_CASE("MpmcRingBuffer multiple producers and consumers", "[mpmc][threading]") {
+  constexpr uint64_t NUM_PRODUCERS = 4;
+  constexpr uint64_t NUM_CONSUMERS = 4;
+  constexpr uint64_t ITEMS_PER_PRODUCER = 50000;
+  constexpr uint64_t TOTAL = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
+
+  // Every value is pushed exactly once, so the consumers' sums and counts
+  // must add up to the totals regardless of how items were distributed
+  bring::MpmcRingBuffer<uint64_t, 64> buffer;
+  std::atomic<uint64_t> consumed{0};
+  std::atomic<uint64_t> sum{0};
+
+  std::vector<std::thread> threads;
+  threads.reserve(NUM_PRODUCERS + NUM_CONSUMERS);
+  for (uint64_t p = 0; p < NUM_PRODUCERS; ++p) {
+    threads.emplace_back([&buffer, p]() {
+      for (uint64_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+        while (!buffer.try_push((p * ITEMS_PER_PRODUCER) + i + 1)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (uint64_t c = 0; c < NUM_CONSUMERS; ++c) {
+    threads.emplace_back([&]() {
+      uint64_t local_sum = 0;
+      while (consumed.load(std::memory_order_relaxed) < TOTAL) {
+        if (auto value = buffer.try_pop()) {
+          local_sum += *value;
+          consumed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+      sum.fetch_add(local_sum, std::memory_order_relaxed);
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+  REQUIRE(consumed.load() == TOTAL);
+  REQUIRE(sum.load() == TOTAL * (TOTAL + 1) / 2);
+  REQUIRE(buffer.is_empty());
+}
+
+TEST_CASE("BroadcastRingBuffer one producer, many readers", "[broadcast][threading]") {
+  constexpr size_t NUM_READERS = 3;
+  constexpr uint64_t NUM_ITEMS = 100000;
+
+  bring::BroadcastRingBuffer<uint64_t, 64, NUM_READERS> buffer;
+  std::array<bool, NUM_READERS> in_order{};
+
+  std::vector<std::thread> readers;
+  readers.reserve(NUM_READERS);
+  for (size_t id = 0; id < NUM_READERS; ++id) {
+    readers.emplace_back([&buffer, &in_order, id]() {
+      uint64_t expected = 0;
+      bool ok = true;
+      while (expected < NUM_ITEMS) {
+        const size_t got = buffer.consume_n(id, 16, [&](const uint64_t &v) {
+          ok = ok && v == expected;
+          ++expected;
+        });
+        if (got == 0) {
+          std::this_thread::yield();
+        }
+      }
+      in_order[id] = ok;
+    });
+  }
+
+  for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+    while (!buffer.try_push(i)) {
+      std::this_thread::yield();
+    }
+  }
+  for (auto &t : readers) {
+    t.join();
+  }
+
+  for (size_t id = 0; id < NUM_READERS; ++id) {
+    REQUIRE(in_order[id]);
+    REQUIRE(buffer.is_empty(id));
+  }
+}
+
+TEST_CASE("RingBuffer stats can be scraped while in use", "[ring_buffer][threading][stats]") {
+  constexpr uint64_t NUM_ITEMS = 100000;
+  bring::RingBuffer<uint64_t, 64, bring::RingStats> buffer;
+  std::atomic<bool> done{false};
+
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+      while (!buffer.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  std::thread consumer([&]() {
+    uint64_t received = 0;
+    while (received < NUM_ITEMS) {
+      if (buffer.try_pop()) {
+        ++received;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  // Scrape concurrently, like a metrics exporter would
+  std::thread exporter([&]() {
+    uint64_t last_pushes = 0;
+    bool monotonic = true;
+    bool consistent = true;
+    while (!done.load(std::memory_order_acquire)) {
+      const auto stats = buffer.stats();
+      monotonic = monotonic && stats.pushes >= last_pushes;
+      last_pushes = stats.pushes;
+      // Observer reads are bounded-stale but never out of range or
+      // self-contradictory
+      const auto state = buffer.get_state();
+      consistent = consistent && state.size <= 64 &&
+                   state.empty == (state.size == 0) &&
+                   state.full == (state.size == 64) &&
+                   buffer.approx_size() <= 64;
+      std::this_thread::yield();
+    }
+    done.store(monotonic && consistent, std::memory_order_relaxed);
+  });
+
+  producer.join();
+  consumer.join();
+  done.store(true, std::memory_order_release);
+  exporter.join();
+
+  const auto stats = buffer.stats();
+  REQUIRE(done.load());
+  REQUIRE(stats.pushes == NUM_ITEMS);
+  REQUIRE(stats.pops == NUM_ITEMS);
+  REQUIRE(stats.high_watermark <= 64);
+}
+
+TEST_CASE("ByteRingBuffer SPSC variable-length records", "[byte_ring][threading]") {
+  constexpr uint64_t NUM_RECORDS = 50000;
+  bring::ByteRingBuffer<4096> buffer;
+
+  // Record i carries its sequence number followed by a size that cycles
+  // through awkward values, so records land on the wrap point often
+  auto record_size = [](uint64_t i) -> size_t { return 9 + (i * 37) % 500; };
+
+  bool in_order = true;
+  std::thread consumer([&]() {
+    for (uint64_t expected = 0; expected < NUM_RECORDS;) {
+      const bool got = buffer.try_consume([&](std::span<const std::byte> record) {
+        uint64_t sequence = 0;
+        std::memcpy(&sequence, record.data(), sizeof(sequence));
+        const bool tail_ok =
+            record.back() == static_cast<std::byte>(expected & 0xff);
+        in_order = in_order && sequence == expected &&
+                   record.size() == record_size(expected) && tail_ok;
+        ++expected;
+      });
+      if (!got) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (uint64_t i = 0; i < NUM_RECORDS; ++i) {
+    const size_t size = record_size(i);
+    std::span<std::byte> space;
+    while ((space = buffer.reserve(size)).empty()) {
+      std::this_thread::yield();
+    }
+    std::memcpy(space.data(), &i, sizeof(i));
+    space.back() = static_cast<std::byte>(i & 0xff);
+    buffer.commit();
+  }
+  consumer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(buffer.is_empty());
+}
+
+namespace {
+// One event loop per thread: the executor posts handles here and run()
+// resumes them on the owning thread until stopped
+class EventLoop {
+  std::mutex _mutex;
+  std::condition_variable _ready;
+  std::deque<std::coroutine_handle<>> _handles;
+  bool _stopped{false};
+
+public:
+  void post(std::coroutine_handle<> handle) {
+    {
+      const std::lock_guard lock(_mutex);
+      _handles.push_back(handle);
+    }
+    _ready.notify_one();
+  }
+
+  void stop() {
+    {
+      const std::lock_guard lock(_mutex);
+      _stopped = true;
+    }
+    _ready.notify_one();
+  }
+
+  void run() {
+    while (true) {
+      std::unique_lock lock(_mutex);
+      _ready.wait(lock, [this] { return _stopped || !_handles.empty(); });
+      if (_handles.empty()) {
+        return;
+      }
+      const std::coroutine_handle<> handle = _handles.front();
+      _handles.pop_front();
+      lock.unlock();
+      handle.resume();
+    }
+  }
+};
+
+struct PostTo {
+  EventLoop *loop;
+  void operator()(std::coroutine_handle<> handle) const { loop->post(handle); }
+};
+
+struct LoopTask {
+  struct promise_type {
+    LoopTask get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+using AsyncRing = bring::RingBuffer<uint64_t, 16, bring::CoroutineWait<>>;
+
+LoopTask produce(AsyncRing &ring, EventLoop &loop, uint64_t count) {
+  for (uint64_t i = 0; i < count; ++i) {
+    co_await ring.async_push(i, PostTo{&loop});
+  }
+  loop.stop();
+}
+
+LoopTask consume(AsyncRing &ring, EventLoop &loop, uint64_t count,
+                 bool &in_order) {
+  for (uint64_t expected = 0; expected < count; ++expected) {
+    const uint64_t value = co_await ring.async_pop(PostTo{&loop});
+    in_order = in_order && value == expected;
+  }
+  loop.stop();
+}
+} // namespace
+
+TEST_CASE("RingBuffer coroutines on two event loops", "[ring_buffer][threading][coroutine]") {
+  constexpr uint64_t NUM_ITEMS = 100000;
+  AsyncRing ring;
+  EventLoop producer_loop;
+  EventLoop consumer_loop;
+  bool in_order = true;
+
+  std::thread consumer([&]() {
+    consume(ring, consumer_loop, NUM_ITEMS, in_order);
+    consumer_loop.run();
+  });
+  std::thread producer([&]() {
+    produce(ring, producer_loop, NUM_ITEMS);
+    producer_loop.run();
+  });
+  producer.join();
+  consumer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(ring.is_empty());
+}
+
+#if defined(__linux__)
+TEST_CASE("RingBuffer EventFdWait drives an epoll consumer", "[ring_buffer][threading][eventfd]") {
+  constexpr uint64_t NUM_ITEMS = 20000;
+  bring::RingBuffer<uint64_t, 64, bring::EventFdWait<>> ring;
+
+  bool in_order = true;
+  bool epoll_ok = true;
+  std::thread consumer([&]() {
+    const int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event interest{};
+    interest.events = EPOLLIN;
+    epoll_ok = epoll >= 0 &&
+               ::epoll_ctl(epoll, EPOLL_CTL_ADD, ring.native_handle(),
+                           &interest) == 0;
+    uint64_t expected = 0;
+    while (epoll_ok && expected < NUM_ITEMS) {
+      while (ring.try_consume([&](uint64_t value) {
+        in_order = in_order && value == expected;
+        ++expected;
+      })) {
+      }
+      if (expected == NUM_ITEMS || !ring.arm_notification()) {
+        continue;
+      }
+      epoll_event ready{};
+      // A lost wakeup would show up as this timing out
+      epoll_ok = ::epoll_wait(epoll, &ready, 1, 5000) == 1;
+      ring.acknowledge_notification();
+    }
+    ::close(epoll);
+  });
+
+  for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+    while (!ring.try_push(i)) {
+      std::this_thread::yield();
+    }
+    if (i % 100 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  consumer.join();
+
+  REQUIRE(epoll_ok);
+  REQUIRE(in_order);
+  REQUIRE(ring.is_empty());
+}
+
+TEST_CASE("RingBuffer EventFdWait pop_wait sleeps in poll", "[ring_buffer][threading][eventfd]") {
+  constexpr uint64_t NUM_ITEMS = 2000;
+  bring::RingBuffer<uint64_t, 16, bring::EventFdWait<4>> ring;
+
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+      ring.push_wait(i);
+      if (i % 200 == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  });
+  bool in_order = true;
+  for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+    in_order = in_order && ring.pop_wait() == i;
+  }
+  producer.join();
+  REQUIRE(in_order);
+}
+
+TEST_CASE("RingBuffer EventFdWait pop_wait_for wakes on a publish", "[ring_buffer][threading][eventfd]") {
+  using namespace std::chrono_literals;
+  bring::RingBuffer<int, 8, bring::EventFdWait<0>> ring;
+
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(20ms);
+    ring.push_wait(42);
+  });
+  // Long timeout: only the publish can end this wait in time
+  const auto start = std::chrono::steady_clock::now();
+  const std::optional<int> value = ring.pop_wait_for(10s);
+  const auto waited = std::chrono::steady_clock::now() - start;
+  producer.join();
+  REQUIRE(value == 42);
+  REQUIRE(waited < 5s);
+}
+#endif
+
+TEST_CASE("RingBuffer SPSC deferred publication", "[ring_buffer][threading][publish]") {
+  constexpr uint64_t NUM_ITEMS = 200000;
+
+  SECTION("Interval with blocking operations") {
+    bring::RingBuffer<uint64_t, 64, bring::DeferredPublish<16>,
+                      bring::SpinYieldWait<>>
+        ring;
+    std::thread producer([&]() {
+      for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+        ring.push_wait(i);
+      }
+      ring.publish();
+    });
+    bool in_order = true;
+    for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+      in_order = in_order && ring.pop_wait() == i;
+    }
+    producer.join();
+    REQUIRE(in_order);
+  }
+
+  SECTION("Manual publish after each burst") {
+    bring::RingBuffer<uint64_t, 256, bring::DeferredPublish<>> ring;
+    std::thread producer([&]() {
+      uint64_t next = 0;
+      while (next < NUM_ITEMS) {
+        for (int burst = 0; burst < 32 && next < NUM_ITEMS; ++burst) {
+          if (!ring.try_push(next)) {
+            std::this_thread::yield();
+            break;
+          }
+          ++next;
+        }
+        ring.publish();
+      }
+    });
+    bool in_order = true;
+    for (uint64_t expected = 0; expected < NUM_ITEMS;) {
+      uint64_t value = 0;
+      if (ring.try_pop_ip(value)) {
+        in_order = in_order && value == expected;
+        ++expected;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    ring.release_consumed();
+    producer.join();
+    REQUIRE(in_order);
+    REQUIRE(ring.is_empty());
+  }
+}
+
+TEST_CASE("OverwriteRingBuffer never hands out torn entries", "[overwrite][threading]") {
+  // Every word of an entry carries the sequence number, so a copy mixing
+  // two pushes is detected
+  struct Entry {
+    std::array<uint64_t, 8> words;
+  };
+  constexpr uint64_t NUM_ITEMS = 1000000;
+  bring::OverwriteRingBuffer<Entry, 64> buffer;
+  std::atomic<bool> producer_done{false};
+
+  std::thread producer([&]() {
+    Entry entry{};
+    for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+      entry.words.fill(i);
+      buffer.push(entry);
+    }
+    producer_done.store(true, std::memory_order_release);
+  });
+
+  uint64_t received = 0;
+  uint64_t last = 0;
+  bool ok = true;
+  const auto check = [&](const Entry &entry) {
+    for (const uint64_t word : entry.words) {
+      ok = ok && word == entry.words[0];
+    }
+    ok = ok && (received == 0 || entry.words[0] > last);
+    last = entry.words[0];
+    ++received;
+  };
+  while (!producer_done.load(std::memory_order_acquire)) {
+    if (buffer.consume_n(32, check) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  buffer.consume_n(64, check);
+  producer.join();
+
+  REQUIRE(ok);
+  REQUIRE(last == NUM_ITEMS - 1);
+  // Every position was either delivered or counted as lost
+  REQUIRE(received + buffer.lost() == NUM_ITEMS);
+}
+
+TEST_CASE("RingSet fans in many producers to a sleeping consumer", "[ring_set][threading]") {
+  constexpr size_t NUM_RINGS = 6;
+  constexpr uint64_t ITEMS_PER_RING = 50000;
+  bring::RingSet<uint64_t, 64, NUM_RINGS> rings;
+  rings.set_batch_limit(0, 4);
+
+  std::vector<std::thread> producers;
+  producers.reserve(NUM_RINGS);
+  for (size_t id = 0; id < NUM_RINGS; ++id) {
+    producers.emplace_back([&rings, id]() {
+      for (uint64_t i = 0; i < ITEMS_PER_RING; ++i) {
+        while (!rings.ring(id).try_push(i)) {
+          std::this_thread::yield();
+        }
+        // Let the consumer go to sleep now and then
+        if (i % 10000 == 0) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+    });
+  }
+
+  std::array<uint64_t, NUM_RINGS> next{};
+  bool in_order = true;
+  uint64_t received = 0;
+  while (received < NUM_RINGS * ITEMS_PER_RING) {
+    received += rings.poll_wait([&](size_t ring, uint64_t &&value) {
+      in_order = in_order && value == next.at(ring);
+      ++next.at(ring);
+    });
+  }
+  for (auto &t : producers) {
+    t.join();
+  }
+
+  REQUIRE(in_order);
+  for (const uint64_t count : next) {
+    REQUIRE(count == ITEMS_PER_RING);
+  }
+  // Drained rings stay marked until a pass finds them empty
+  REQUIRE(rings.poll([](size_t, uint64_t &&) {}) == 0);
+  REQUIRE_FALSE(rings.any_ready());
+}
+
+TEST_CASE("Pipeline runs chained stages in order", "[pipeline][threading]") {
+  constexpr uint64_t NUM_ITEMS = 200000;
+  std::vector<uint64_t> out;
+  out.reserve(NUM_ITEMS);
+
+  auto pipeline = bring::make_pipeline<uint64_t, 64>(
+      bring::stage([](uint64_t &&v) { return v * 3; }).batch_size(8),
+      bring::fused([](uint64_t &&v) { return std::to_string(v); }),
+      bring::stage([](std::string &&s) { return std::stoull(s) + 1; })
+          .wait<bring::AtomicWait<>>(),
+      bring::stage([&](uint64_t &&v) { out.push_back(v); })
+          .wait<bring::SpinYieldWait<>>());
+  STATIC_REQUIRE(decltype(pipeline)::stages() == 4);
+
+  pipeline.start();
+  for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+    pipeline.push(i);
+  }
+  pipeline.close();
+
+  REQUIRE(out.size() == NUM_ITEMS);
+  bool in_order = true;
+  for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+    in_order = in_order && out[i] == i * 3 + 1;
+  }
+  REQUIRE(in_order);
+  for (size_t k = 0; k < pipeline.stages(); ++k) {
+    REQUIRE(pipeline.stage_stats(k).processed == NUM_ITEMS);
+  }
+  REQUIRE(pipeline.stage_stats(1).blocked.count() == 0);
+}
+
+TEST_CASE("Pipeline reports stage exceptions from close", "[pipeline][threading]") {
+  std::atomic<uint64_t> sunk{0};
+  auto pipeline = bring::make_pipeline<int, 16>(
+      bring::stage([](int &&v) {
+        if (v == 50) {
+          throw std::runtime_error("bad input");
+        }
+        return v;
+      }),
+      bring::stage([&](int && /*v*/) { sunk.fetch_add(1); }));
+  pipeline.start();
+  for (int i = 0; i < 1000; ++i) {
+    pipeline.push(i);
+  }
+  REQUIRE_THROWS_AS(pipeline.close(), std::runtime_error);
+  // Elements before the failure went through; the rest were discarded
+  REQUIRE(sunk.load() == 50);
+  REQUIRE(pipeline.stage_stats(0).processed == 50);
+}
+
+TEST_CASE("Pipeline shuts down when destroyed", "[pipeline][threading]") {
+  std::atomic<uint64_t> sunk{0};
+  {
+    auto pipeline = bring::make_pipeline<int, 16>(
+        bring::stage([&](int && /*v*/) { sunk.fetch_add(1); }));
+    pipeline.start();
+    for (int i = 0; i < 100; ++i) {
+      pipeline.push(i);
+    }
+  }
+  REQUIRE(sunk.load() == 100);
+}
+
+TEST_CASE("PoolChannel transfers heap payloads without reallocating",
+          "[pool_channel][threading]") {
+  constexpr size_t NUM_MESSAGES = 200000;
+  constexpr size_t PAYLOAD = 256;
+
+  bring::PoolChannel<std::vector<std::byte>, 64, bring::SpinYieldWait<>>
+      channel([](std::vector<std::byte> &buffer) { buffer.reserve(PAYLOAD); });
+  std::atomic<size_t> corrupt{0};
+  std::atomic<size_t> reallocated{0};
+
+  std::thread producer([&]() {
+    for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+      auto lease = channel.acquire_wait();
+      const std::byte *before = lease->data();
+      lease->clear();
+      for (size_t j = 0; j < PAYLOAD; ++j) {
+        lease->push_back(static_cast<std::byte>((i + j) & 0xFF));
+      }
+      if (lease->data() != before) {
+        reallocated.fetch_add(1, std::memory_order_relaxed);
+      }
+      channel.send(std::move(lease));
+    }
+  });
+
+  std::thread consumer([&]() {
+    for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+      auto message = channel.receive_wait();
+      if (message->size() != PAYLOAD ||
+          message->front() != static_cast<std::byte>(i & 0xFF) ||
+          message->back() !=
+              static_cast<std::byte>((i + PAYLOAD - 1) & 0xFF)) {
+        corrupt.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  REQUIRE(corrupt.load() == 0);
+  REQUIRE(reallocated.load() == 0);
+  REQUIRE(channel.available() == channel.capacity());
+}
+
+TEST_CASE("RingBuffer latency sampling under load",
+          "[ring_buffer][latency][threading]") {
+  constexpr size_t NUM_ITEMS = 1 << 18;
+  constexpr size_t EVERY = 64;
+
+  bring::RingBuffer<uint64_t, 1024, bring::LatencySampling<EVERY>,
+                    bring::SpinYieldWait<>>
+      buffer;
+  std::atomic<bool> done{false};
+  std::atomic<size_t> out_of_order{0};
+
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+      buffer.push_wait(i);
+    }
+  });
+
+  std::thread consumer([&]() {
+    uint64_t expected = 0;
+    while (expected < NUM_ITEMS) {
+      buffer.consume_all([&](uint64_t &&value) {
+        if (value != expected) {
+          out_of_order.fetch_add(1, std::memory_order_relaxed);
+        }
+        ++expected;
+      });
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  // Exporter reading the histogram while it is written
+  uint64_t last_count = 0;
+  size_t inconsistent = 0;
+  while (!done.load(std::memory_order_acquire)) {
+    const uint64_t count = buffer.latency().count();
+    if (count < last_count ||
+        buffer.latency().percentile(0.99) > buffer.latency().max()) {
+      ++inconsistent;
+    }
+    last_count = count;
+    std::this_thread::yield();
+  }
+
+  producer.join();
+  consumer.join();
+
+  REQUIRE(out_of_order.load() == 0);
+  REQUIRE(inconsistent == 0);
+  // Every * Slots covers the capacity, so no sample is dropped
+  REQUIRE(buffer.latency().count() == NUM_ITEMS / EVERY);
+}
+
+TEST_CASE("PriorityRingBuffer keeps each lane in order",
+          "[priority][threading]") {
+  constexpr uint64_t NUM_ITEMS = 300000;
+  constexpr size_t LANES = 3;
+
+  bring::PriorityRingBuffer<uint64_t, bring::Lanes<16, 64, 1024>,
+                            bring::WeightedPriority<8, 4, 1>>
+      buffer;
+
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+      // Sequence number in the high bits, lane in the low ones
+      const size_t lane = (i * 7) % LANES;
+      while (!buffer.try_push(lane, (i << 2) | lane)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::array<uint64_t, LANES> last{};
+  std::array<uint64_t, LANES> received{};
+  size_t out_of_order = 0;
+  uint64_t total = 0;
+  while (total < NUM_ITEMS) {
+    const size_t consumed = buffer.consume_n(32, [&](uint64_t &&value) {
+      const size_t lane = value & 3;
+      const uint64_t sequence = (value >> 2) + 1;
+      if (sequence <= last.at(lane)) {
+        ++out_of_order;
+      }
+      last.at(lane) = sequence;
+      ++received.at(lane);
+    });
+    total += consumed;
+    if (consumed == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  REQUIRE(out_of_order == 0);
+  REQUIRE(received.at(0) + received.at(1) + received.at(2) == NUM_ITEMS);
+  REQUIRE(received.at(0) == NUM_ITEMS / LANES);
+  REQUIRE(buffer.is_empty());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("ShmRingBuffer transfers between processes", "[shm][threading]") {
+  constexpr uint64_t NUM_ITEMS = 100000;
+  using Ring = bring::ShmRingBuffer<uint64_t, 256>;
+  const std::string name = "/bring_mt_" + std::to_string(getpid());
+
+  Ring producer = Ring::create(name);
+  const pid_t child = fork();
+  REQUIRE(child >= 0);
+  if (child == 0) {
+    // Consumer process: report the result through the exit status only, no
+    // test framework calls after fork
+    int status = 0;
+    try {
+      Ring consumer = Ring::attach(name);
+      for (uint64_t expected = 0; expected < NUM_ITEMS;) {
+        uint64_t value = 0;
+        if (consumer.try_pop_ip(value)) {
+          status = value == expected ? status : 1;
+          ++expected;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    } catch (...) {
+      status = 2;
+    }
+    _exit(status);
+  }
+
+  for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+    while (!producer.try_push(i)) {
+      std::this_thread::yield();
+    }
+  }
+  int status = 0;
+  REQUIRE(waitpid(child, &status, 0) == child);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+  REQUIRE(producer.is_empty());
+}
+#endif
+
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers,bugprone-unchecked-optional-access,bugprone-chained-comparison,readability-identifier-length,readability-function-cognitive-complexity,readability-identifier-naming)